@@ -155,7 +155,7 @@ static ValuePtr FindFile(const ValueMap& args, DAGBuilder &builder)
 	assert(list);
 
 	vector<string> directories;
-	for (const ValuePtr& v : list->elements())
+	for (const ValuePtr& v : *list)
 	{
 		auto file = std::dynamic_pointer_cast<File>(v);
 		assert(file);
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019 Jonathan Anderson
+#
+# This software was developed at Memorial University of Newfoundland
+# under the NSERC Discovery program (RGPIN-2015-06048).
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+# OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGE.
+#
+"""
+Benchmark the Fabrique evaluator on a large, generated build description.
+
+The default 'calls' workload stresses the parts of evaluation that run once
+per value, call or name reference (scope lookups, function calls, argument
+naming, value definition) rather than parsing or backend output. The 'records'
+workload passes nested records through typed function parameters and
+annotated values, which stresses subtype checking. By default debugging is off,
+which is the case that matters for real-world performance.
+
+Usage: evaluate.py [--workload calls|records] [--values N] [--runs R]
+                   [--debug PATTERN] fab [fab ...]
+
+Pass several fab binaries (e.g., before and after a change) to compare them.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+args = argparse.ArgumentParser()
+args.add_argument('fab', nargs='+', help='fab binary (or binaries) to benchmark')
+args.add_argument('--values', type=int, default=2000,
+                  help='number of top-level values to generate')
+args.add_argument('--runs', type=int, default=5, help='runs per binary')
+args.add_argument('--debug', help='debug pattern to pass to fab')
+args.add_argument('--workload', choices=('calls', 'records'), default='calls',
+                  help='kind of build description to generate')
+args = args.parse_args()
+
+
+def generate_calls(f, count):
+    f.write('''
+increment = function(x:int): int { x + 1 };
+twice = function(f:(int)->int, x:int): int { f(f(x)) };
+
+cc = action('cc -c ${src} -o ${obj}' <- src:file[in], obj:file[out]);
+''')
+
+    for i in range(count):
+        f.write(f'''
+v{i} = twice(increment, {i});
+r{i} = record {{ value = v{i}; doubled = v{i} + v{i}; }};
+l{i} = foreach x <- [ 1 2 3 4 ] increment(x + r{i}.doubled);
+o{i} = cc(file('src{i}.c'), file('src{i}.o'));
+''')
+
+
+def generate_records(f, count):
+    point = 'record[x:int, y:int, label:string]'
+    box = f'record[origin:{point}, extent:{point}, name:string]'
+
+    f.write(f'''
+width = function(b:{box}): int {{ b.extent.x + b.origin.x }};
+shift = function(p:{point}, d:int): {point}
+{{
+    record {{ x = p.x + d; y = p.y + d; label = p.label; }}
+}};
+grow = function(b:{box}, d:int): {box}
+{{
+    record {{ origin = b.origin; extent = shift(b.extent, d); name = b.name; }}
+}};
+''')
+
+    for i in range(count):
+        f.write(f'''
+p{i}:{point} = record {{ x = {i}; y = {i}; label = 'p{i}'; }};
+b{i}:{box} = record {{ origin = p{i}; extent = shift(p{i}, 1); name = 'b{i}'; }};
+g{i}:{box} = grow(grow(b{i}, 1), 2);
+w{i}:int = width(g{i}) + width(b{i});
+''')
+
+
+generate = {
+    'calls': generate_calls,
+    'records': generate_records,
+}[args.workload]
+
+
+with tempfile.TemporaryDirectory(prefix='fabrique-benchmark') as tmpdir:
+    fabfile = os.path.join(tmpdir, 'fabfile')
+    with open(fabfile, 'w') as f:
+        generate(f, args.values)
+
+    for fab in args.fab:
+        command = [fab, '--format=null', '--output', tmpdir, fabfile]
+        if args.debug:
+            command.append(f'--debug={args.debug}')
+
+        times = []
+        for _ in range(args.runs):
+            start = time.perf_counter()
+            subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+            times.append(time.perf_counter() - start)
+
+        best = min(times)
+        mean = sum(times) / len(times)
+        print(f'{fab}: best {best * 1000:.1f} ms, mean {mean * 1000:.1f} ms'
+              f' ({args.workload}: {args.values} values, {args.runs} runs)')
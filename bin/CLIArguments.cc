@@ -62,7 +62,12 @@ enum optionNames
 	DumpAST,
 	PrettyPrintDAG,
 	PrintOutput,
+	NoCache,
+	NoValidate,
 	DebugPattern,
+	TraceFile,
+	Jobs,
+	Only,
 };
 
 
@@ -115,9 +120,16 @@ const option::Descriptor usage[] =
 		"\n"
 		"Usage:\n"
 		"  fab [options] <fabfile>\n"
+		"  fab [options] query <query> [<fabfile>]\n"
 		"\n"
 		"Arguments:\n"
 		"  <fabfile>        Build description; defaults to 'fabfile'\n"
+		"  <query>          Print files related to others in the build graph\n"
+		"                   (answered from the generation cache when possible):\n"
+		"                     deps(f)          files that f depends on\n"
+		"                     rdeps(f)         files that depend on f\n"
+		"                     somepath(f, g)   a chain of dependencies from f to g\n"
+		"                     allpaths(f, g)   all files on chains from f to g\n"
 		"\n"
 		"Options:"
 	},
@@ -157,10 +169,30 @@ const option::Descriptor usage[] =
 		PrintOutput, Enable, "", "stdout", option::Arg::None,
 		"  --stdout         Print the result to stdout"
 	},
+	{
+		NoCache, Enable, "", "no-cache", option::Arg::None,
+		"  --no-cache       Regenerate outputs even if no inputs have changed"
+	},
+	{
+		NoValidate, Enable, "", "no-validate", option::Arg::None,
+		"  --no-validate    Don't check the DAG for cycles or conflicting outputs"
+	},
 	{
 		DebugPattern, SetOpt, "", "debug", option::Arg::Optional,
 		"  --debug          Show debug output (e.g. 'parser', equivalent to 'parser.*')"
 	},
+	{
+		TraceFile, SetOpt, "", "trace", Required,
+		"  --trace          Write a timeline of the run (Chrome trace format) to a file"
+	},
+	{
+		Jobs, SetOpt, "j", "jobs", Required,
+		"  -j,--jobs        Evaluate up to N imports at once (0: one per core)"
+	},
+	{
+		Only, AppendOpt, "", "only", Required,
+		"  --only           Only generate these (comma-separated) top-level targets"
+	},
 	{ 0, 0, nullptr, nullptr, nullptr, nullptr }
 };
 
@@ -180,7 +212,13 @@ CLIArguments CLIArguments::Parse(int argc, char *argv[])
 	option::Parser opts(usage, argc - 1, argv + 1,
 	                    options.data(), buffer.data());
 
-	if (opts.nonOptionsCount() > 1)
+	// The 'query' subcommand takes a query and an optional fabfile.
+	const bool query =
+		opts.nonOptionsCount() > 0 and string(opts.nonOption(0)) == "query";
+
+	const int positional = query ? 2 : 0;
+	if (opts.nonOptionsCount() > positional + 1
+	    or opts.nonOptionsCount() < positional)
 	{
 		return {};
 	}
@@ -193,8 +231,8 @@ CLIArguments CLIArguments::Parse(int argc, char *argv[])
 
 	const bool help = options[Help];
 
-	const string input = opts.nonOptionsCount() == 1
-	                      ? opts.nonOption(0)
+	const string input = opts.nonOptionsCount() == positional + 1
+	                      ? opts.nonOption(positional)
 	                      : "fabfile";
 
 	const bool haveOutputDir = options[OutputDirectory];
@@ -223,11 +261,30 @@ CLIArguments CLIArguments::Parse(int argc, char *argv[])
 	if (formats.empty())
 		formats.emplace_back("ninja");
 
+	std::vector<string> only;
+	for (Option *o = options[Only]; o; o = o->next())
+	{
+		std::vector<string> csv = Split(o->arg);
+		only.insert(only.end(), csv.begin(), csv.end());
+	}
+
 	const string debugPattern =
 		options[DebugPattern]
 		? (options[DebugPattern].arg ? options[DebugPattern].arg : "*")
 		: "none";
 
+	unsigned long jobs = 1;
+	if (options[Jobs])
+	{
+		const string j = options[Jobs].arg;
+		if (j.empty() or j.find_first_not_of("0123456789") != string::npos)
+		{
+			throw UserError("invalid number of jobs: '" + j + "'");
+		}
+
+		jobs = std::stoul(j);
+	}
+
 	return CLIArguments {
 		true,
 		executable,
@@ -242,7 +299,13 @@ CLIArguments CLIArguments::Parse(int argc, char *argv[])
 		options[DumpAST],
 		options[PrettyPrintDAG],
 		options[PrintOutput],
-		debugPattern
+		options[NoCache],
+		options[NoValidate],
+		debugPattern,
+		options[TraceFile] ? options[TraceFile].arg : "",
+		jobs,
+		query ? opts.nonOption(1) : "",
+		only,
 	};
 }
 
@@ -276,9 +339,25 @@ std::vector<string> CLIArguments::ArgVector()
 	else
 		argv.push_back("--output=" + platform::AbsoluteDirectory(output));
 
+	if (noCache)
+		argv.push_back("--no-cache");
+
+	if (noValidate)
+		argv.push_back("--no-validate");
+
 	for (const string& d : definitions)
 		argv.push_back("-D '" + d + "'");
 
+	// Regenerating a sliced build description should keep it sliced:
+	if (not onlyTargets.empty())
+		argv.push_back("--only=" + join(onlyTargets, ","));
+
+	// Don't pass --trace along: a trace describes a single run, so we shouldn't
+	// overwrite it every time that the build description is regenerated.
+	// Similarly, --jobs doesn't affect our output, so leave it out:
+	// a build description should not depend on how it was generated.
+	// A query is a one-off question rather than part of generation.
+
 	return argv;
 }
 
@@ -308,7 +387,13 @@ void CLIArguments::Print(Bytestream& out)
 		<< ARG(dumpAST)
 		<< ARG(printDAG)
 		<< ARG(printOutput)
+		<< ARG(noCache)
+		<< ARG(noValidate)
 		<< ARG(debugPattern)
+		<< ARG(traceFile)
+		<< ARG(jobs)
+		<< ARG(query)
+		<< ARG(onlyTargets)
 		<< Bytestream::Operator << "}"
 		<< Bytestream::Reset
 		;
@@ -74,8 +74,22 @@ public:
 	const bool dumpAST;
 	const bool printDAG;
 	const bool printOutput;
+	const bool noCache;
+	const bool noValidate;
 
 	const std::string debugPattern;
+
+	//! Where to write a trace of the run (empty if not tracing).
+	const std::string traceFile;
+
+	//! How many imports to evaluate at once (0: one per core).
+	const unsigned long jobs;
+
+	//! A query to answer about the build graph (empty if not querying).
+	const std::string query;
+
+	//! Top-level targets to generate (empty means all of them).
+	const std::vector<std::string> onlyTargets;
 };
 
 } // namespace fabrique
@@ -35,6 +35,7 @@
 #include <fabrique/builtins.hh>
 #include <fabrique/Bytestream.hh>
 #include <fabrique/FabBuilder.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/UserError.hh>
 
 #include <fabrique/ast/ASTDump.hh>
@@ -90,6 +91,11 @@ int main(int argc, char *argv[]) {
 		args.Print(argDebug);
 		argDebug << Bytestream::Reset << "\n";
 
+		if (not args.traceFile.empty())
+		{
+			Trace::Enable(args.traceFile);
+		}
+
 		//
 		// Translate command-line arguments into values for the
 		// Fabrique instance using a FabBuilder:
@@ -103,13 +109,20 @@ int main(int argc, char *argv[]) {
 			.outputDirectory(args.output)
 			.pluginPaths(PluginSearchPaths(args.executable))
 			.printToStdout(args.printOutput)
+			.useCache(not args.noCache)
+			.validateDAG(not args.noValidate)
+			.jobs(static_cast<unsigned int>(args.jobs))
 			.regenerationCommand(args.executable + args.str())
+			.executable(args.executable)
+			.query(args.query)
+			.onlyTargets(args.onlyTargets)
 			.build()
 			;
 
 		fab.AddArguments(args.definitions);
 		fab.Process(args.input);
 
+		Trace::Finish();
 		return 0;
 	}
 	catch (const UserError& e)
@@ -141,5 +154,20 @@ int main(int argc, char *argv[]) {
 	}
 
 	err << Bytestream::Reset << "\n";
+
+	// Even a failed run's timeline may be interesting:
+	try
+	{
+		Trace::Finish();
+	}
+	catch (const UserError& e)
+	{
+		err
+			<< Bytestream::Error << "Error"
+			<< Bytestream::Reset << ": " << e
+			<< Bytestream::Reset << "\n"
+			;
+	}
+
 	return 1;
 }
@@ -43,26 +43,28 @@ cxx_srcs = {
     ),
     'lib/': (
         'AssertionFailure', 'Bytestream', 'ErrorReport', 'Fabrique', 'FabBuilder',
-        'Printable', 'SemanticException',
-        'SourceCodeException', 'SourceLocation', 'SourceRange', 'UserError',
-        'builtins', 'names', 'strings',
+        'GenerationCache', 'Printable', 'SemanticException',
+        'SourceCodeException', 'SourceFiles', 'SourceLocation', 'SourceRange',
+        'Trace',
+        'UserError', 'WorkerPool', 'builtins', 'hash', 'names', 'strings',
     ),
     'lib/ast/': (
         'ASTDump', 'Action', 'Argument', 'Arguments', 'BinaryOperation', 'Call',
-        'CompoundExpr', 'Conditional', 'EvalContext', 'Expression',
+        'CompoundExpr', 'Conditional', 'Demand', 'EvalContext', 'Expression',
         'FieldAccess', 'FieldQuery', 'FileList', 'FilenameLiteral',
         'Foreach', 'Function', 'HasParameters', 'Identifier', 'List',
-        'NameReference', 'Node', 'Parameter', 'Record', 'SyntaxError',
-        'TypeDeclaration', 'TypeReference',
+        'NameReference', 'Node', 'Optimizer', 'Parameter', 'Record', 'Resolver',
+        'SyntaxError',
+        'TypeChecker', 'TypeDeclaration', 'TypeReference',
         'UnaryOperation', 'Value', 'Visitor', 'literals',
     ),
     'lib/backend/': (
         'Backend', 'Dot', 'Make', 'Ninja', 'Null',
     ),
     'lib/dag/': (
-        'Build', 'Callable', 'DAG', 'DAGBuilder',
-        'File', 'Formatter', 'Function',
-                'List', 'Parameter', 'Primitive',
+        'Adjacency', 'Build', 'Callable', 'DAG', 'DAGBuilder', 'DAGIndex',
+        'File', 'FileGraph', 'Formatter', 'Function', 'Hash',
+                'List', 'Owner', 'Parameter', 'PathTable', 'Primitive',
                 'Record', 'Rule', 'TypeReference',
                 'UndefinedValueException',
                 'Value', 'Visitor',
@@ -78,7 +80,8 @@ cxx_srcs = {
         'Loader', 'Plugin', 'Registry',
     ),
     'lib/types/': (
-        'BooleanType', 'FileType', 'FunctionType', 'IntegerType', 'RecordType',
+        'BooleanType', 'FileType', 'FunctionType', 'IntegerType', 'RecordShape',
+        'RecordType',
         'SequenceType', 'StringType', 'Type', 'TypeContext', 'TypeError', 'Typed',
     ),
     'vendor/antlr-cxx-runtime/': (
@@ -90,6 +90,46 @@ public:
 	static void SetDebugPattern(const std::string&);
 	static void SetDebugStream(Bytestream&);
 
+	/**
+	 * A named debug channel whose state (enabled or disabled) is resolved
+	 * when the debug pattern is set rather than every time it is used.
+	 *
+	 * Hot code paths should use a channel rather than calling @ref Debug
+	 * with a name, and should check whether the channel is enabled before
+	 * doing any expensive formatting. Channels are never unregistered,
+	 * so they must have static storage duration:
+	 *
+	 * ```
+	 * static Bytestream::DebugChannel dbg("ast.scope.lookup");
+	 * if (dbg)
+	 * {
+	 *     dbg << "found " << *value << "\n";
+	 * }
+	 * ```
+	 */
+	class DebugChannel
+	{
+	public:
+		//! Constructor: @a name must outlive the channel (e.g., a literal).
+		explicit DebugChannel(const char *name);
+
+		explicit operator bool() const { return enabled_; }
+
+		//! The debug stream if this channel is enabled, a null stream if not.
+		Bytestream& stream() const;
+
+		template<typename T>
+		Bytestream& operator << (const T &x) const { return stream() << x; }
+
+	private:
+		DebugChannel(const DebugChannel&) = delete;
+		DebugChannel& operator= (const DebugChannel&) = delete;
+
+		friend class Bytestream;
+		const char *name_;
+		bool enabled_;
+	};
+
 	/**
 	 * Construct a formatted @ref fabrique::Bytestream to wrap an @ref std::ostream.
 	 *
@@ -53,6 +53,9 @@ public:
 	FabBuilder& printDAG(bool p) { printDAG_ = p; return *this; }
 	FabBuilder& dumpASTs(bool p) { dumpASTs_ = p; return *this; }
 	FabBuilder& printToStdout(bool p) { stdout_ = p; return *this; }
+	FabBuilder& useCache(bool c) { useCache_ = c; return *this; }
+	FabBuilder& validateDAG(bool v) { validateDAG_ = v; return *this; }
+	FabBuilder& jobs(unsigned int j) { jobs_ = j; return *this; }
 
 	FabBuilder& backends(std::vector<std::string> backendNames);
 	FabBuilder& outputDirectory(std::string d);
@@ -69,18 +72,42 @@ public:
 		return *this;
 	}
 
+	FabBuilder& executable(std::string path)
+	{
+		executable_ = std::move(path);
+		return *this;
+	}
+
+	FabBuilder& query(std::string q)
+	{
+		query_ = std::move(q);
+		return *this;
+	}
+
+	FabBuilder& onlyTargets(std::vector<std::string> targets)
+	{
+		onlyTargets_ = std::move(targets);
+		return *this;
+	}
+
 private:
 	bool parseOnly_;
 	bool printASTs_;
 	bool printDAG_;
 	bool dumpASTs_;
 	bool stdout_;
+	bool useCache_;
+	bool validateDAG_;
+	unsigned int jobs_;
 
 	UniqPtrVec<backend::Backend> backends_;
 	Fabrique::ErrorReporter err_;
 	std::string outputDir_;
 	std::vector<std::string> pluginPaths_;
 	std::string regenCommand_;
+	std::string executable_;
+	std::string query_;
+	std::vector<std::string> onlyTargets_;
 };
 
 } // namespace fabrique
@@ -35,7 +35,10 @@
 
 #include <fabrique/builtins.hh>
 #include <fabrique/ErrorReport.hh>
+#include <fabrique/GenerationCache.hh>
 #include <fabrique/backend/Backend.hh>
+#include <fabrique/dag/DAG.hh>
+#include <fabrique/dag/FileGraph.hh>
 #include <fabrique/dag/Value.hh>
 #include <fabrique/parsing/Parser.hh>
 #include <fabrique/types/TypeContext.hh>
@@ -61,9 +64,11 @@ public:
 	 * it is probably more convenient to use a FabBuilder.
 	 */
 	Fabrique(bool parseOnly, bool printASTs, bool dumpASTs, bool printDAG,
-	         bool printToStdout, UniqPtrVec<backend::Backend> backends,
+	         bool printToStdout, bool useCache, bool validateDAG,
+	         unsigned int jobs, UniqPtrVec<backend::Backend> backends,
 		 std::string outputDir, std::vector<std::string> pluginSearchPaths,
-		 std::string regenCommand, ErrorReporter);
+		 std::string regenCommand, std::string executable, std::string query,
+		 std::vector<std::string> onlyTargets, ErrorReporter);
 
 	Fabrique(Fabrique&&);
 
@@ -76,6 +81,13 @@ public:
 	 *
 	 * Depending on the options and backends we have been configured with,
 	 * this may also cause DAG and Backend processing to occur.
+	 *
+	 * If the generation cache is enabled and nothing has changed since the
+	 * last time that this file was processed, previously-generated outputs
+	 * will be written without re-parsing or re-evaluating anything.
+	 *
+	 * If we have been given a query, we answer it (from the cache, if
+	 * possible) instead of generating any outputs.
 	 */
 	void Process(const std::string &filename);
 
@@ -95,9 +107,36 @@ private:
 	void ReportError(std::string message, SourceRange, ErrorReport::Severity,
 	                 std::string detail);
 
+	/**
+	 * Process the DAG with all of our backends, rendering each backend's
+	 * output into a buffer rather than a file.
+	 */
+	std::vector<GenerationCache::Output> Render(const dag::DAG&);
+
+	/**
+	 * Answer our query (e.g., `deps(foo.o)`) by printing the names of the
+	 * matching files to stdout.
+	 */
+	void Query(const dag::FileGraph&) const;
+
+	//! Describe everything (other than input files) that affects our outputs.
+	std::vector<std::string> CacheConfiguration(const std::string &fabfile) const;
+
+	//! Write generated files into the output directory.
+	void WriteOutputs(const std::vector<GenerationCache::Output>&);
+
 	const bool parseOnly_;
+	const bool printASTs_;
+	const bool dumpASTs_;
 	const bool printDAG_;
 	const bool printToStdout_;
+	const bool useCache_;
+
+	//! Check the DAG for cycles and conflicting outputs before using it.
+	const bool validateDAG_;
+
+	//! How many imports to evaluate concurrently (0: one per core).
+	const unsigned int jobs_;
 
 	const UniqPtrVec<backend::Backend> backends_;
 
@@ -107,6 +146,12 @@ private:
 
 	dag::ValueMap arguments_;
 
+	//! Command-line definitions, as passed to @ref AddArguments
+	std::vector<std::string> definitions_;
+
+	//! Have any errors or warnings been reported while processing?
+	bool diagnosticsReported_;
+
 	std::vector<std::string> outputFiles_;
 
 	const std::string outputDirectory_;
@@ -114,6 +159,15 @@ private:
 
 	//! The command used to regenerate our build description (if set)
 	const std::string regenerationCommand_;
+
+	//! The fab executable, whose contents the generation cache depends on
+	const std::string executable_;
+
+	//! A query to answer instead of generating outputs (if set)
+	const std::string query_;
+
+	//! Only generate these top-level targets and their dependencies (if set)
+	const std::vector<std::string> onlyTargets_;
 };
 
 } // namespace fabrique
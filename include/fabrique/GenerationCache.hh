@@ -0,0 +1,108 @@
+//! @file  GenerationCache.hh    Declaration of fabrique::GenerationCache
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_GENERATION_CACHE_H_
+#define FAB_GENERATION_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace fabrique {
+
+/**
+ * A persistent cache of generated build descriptions (e.g., `build.ninja`).
+ *
+ * The cache is keyed on everything that can affect generation: the configuration
+ * of the Fabrique instance (command-line definitions, backends, plugin search paths,
+ * etc.) and the contents of every input file (Fabrique files, plugin libraries and
+ * the fab executable itself) used in the previous generation. When none of these
+ * has changed, the previous outputs can be reproduced without parsing, evaluation
+ * or DAG construction.
+ *
+ * Side effects of evaluation (e.g., calls to `print`) can't be replayed on a hit,
+ * so generations that have them should not be cached.
+ */
+class GenerationCache
+{
+public:
+	//! A generated file: a filename (relative to the output directory) and contents.
+	using Output = std::pair<std::string, std::string>;
+
+	//! The name of the cache file within an output directory.
+	static const char Filename[];
+
+	/**
+	 * Constructor.
+	 *
+	 * @param   filename        the cache file to load from and save to
+	 * @param   configuration   strings that describe the Fabrique configuration
+	 */
+	GenerationCache(std::string filename, std::vector<std::string> configuration);
+
+	/**
+	 * Load previously-generated outputs from the cache file.
+	 *
+	 * @returns true if the cache file exists, was generated with the same
+	 *          configuration and none of the inputs that it names have changed
+	 */
+	bool Load();
+
+	//! Outputs retrieved by a successful @ref Load.
+	const std::vector<Output>& outputs() const { return outputs_; }
+
+	//! The serialized @ref dag::FileGraph retrieved by a successful @ref Load.
+	const std::string& fileGraph() const { return fileGraph_; }
+
+	/**
+	 * Save generated outputs to the cache file.
+	 *
+	 * @param   inputs     every file that the outputs were generated from
+	 * @param   outputs    the generated files
+	 * @param   fileGraph  the serialized file graph (for answering queries)
+	 */
+	void Save(const std::vector<std::string> &inputs, std::vector<Output> outputs,
+	          std::string fileGraph = "");
+
+private:
+	//! Compute the cache key for a set of input files.
+	uint64_t Key(const std::vector<std::string> &inputs) const;
+
+	const std::string filename_;
+	const std::vector<std::string> configuration_;
+	std::vector<Output> outputs_;
+	std::string fileGraph_;
+};
+
+} // namespace fabrique
+
+#endif  // FAB_GENERATION_CACHE_H_
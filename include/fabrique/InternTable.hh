@@ -0,0 +1,100 @@
+//! @file InternTable.hh    Declaration of @ref fabrique::InternTable
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_INTERN_TABLE_H_
+#define FAB_INTERN_TABLE_H_
+
+#include <fabrique/AssertionFailure.hh>
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fabrique {
+
+/**
+ * A thread-safe table that maps strings to small integer IDs and back.
+ *
+ * ID zero always refers to the empty string. Names are stored in a deque,
+ * which never moves its elements, so references returned by @ref Name
+ * remain valid for the life of the table.
+ */
+template<typename ID>
+class InternTable
+{
+public:
+	//! @param what   what the table holds (for assertion messages)
+	InternTable(const char *what)
+		: what_(what), names_({ "" }), ids_({ { "", 0 } })
+	{
+	}
+
+	//! Find the ID of a name, adding the name to the table if necessary.
+	ID Intern(const std::string &name)
+	{
+		std::lock_guard<std::mutex> lock(lock_);
+
+		auto i = ids_.find(name);
+		if (i != ids_.end())
+		{
+			return i->second;
+		}
+
+		FAB_ASSERT(names_.size() < std::numeric_limits<ID>::max(),
+		           std::string("too many ") + what_);
+
+		const ID id = static_cast<ID>(names_.size());
+		names_.push_back(name);
+		ids_.emplace(name, id);
+
+		return id;
+	}
+
+	//! Look up a name by ID.
+	const std::string& Name(ID id)
+	{
+		std::lock_guard<std::mutex> lock(lock_);
+
+		FAB_ASSERT(id < names_.size(), std::string("invalid ID in ") + what_);
+		return names_[id];
+	}
+
+private:
+	const char *what_;
+	std::mutex lock_;
+	std::deque<std::string> names_;
+	std::unordered_map<std::string, ID> ids_;
+};
+
+} // namespace fabrique
+
+#endif  // FAB_INTERN_TABLE_H_
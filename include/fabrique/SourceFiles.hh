@@ -0,0 +1,61 @@
+//! @file SourceFiles.hh    Declaration of @ref fabrique::SourceFiles
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_SOURCE_FILES_H_
+#define FAB_SOURCE_FILES_H_
+
+#include <cstdint>
+#include <string>
+
+namespace fabrique {
+
+/**
+ * The table of source files that @ref SourceLocation objects refer to.
+ *
+ * Every AST node and DAG value has a source range, so rather than storing
+ * a copy of a filename in each of them, we store a small integer that
+ * identifies the file in this (process-wide, thread-safe) table.
+ */
+class SourceFiles
+{
+public:
+	//! Identifies a source file; zero means "no file".
+	using ID = uint32_t;
+
+	//! Find the ID of a file, adding the file to the table if necessary.
+	static ID Intern(const std::string &filename);
+
+	//! Look up the name of a file (or the empty string for ID zero).
+	static const std::string& Name(ID);
+};
+
+} // namespace fabrique
+
+#endif  // FAB_SOURCE_FILES_H_
@@ -36,33 +36,58 @@
 #ifndef FAB_SOURCE_LOCATION_H_
 #define FAB_SOURCE_LOCATION_H_
 
-#include <fabrique/Printable.hh>
-#include <fabrique/UniqPtr.hh>
+#include <fabrique/SourceFiles.hh>
 
+#include <cstdint>
 #include <string>
 
 namespace fabrique {
 
-//! A location in the original source code.
-class SourceLocation : public Printable
+class Bytestream;
+
+
+/**
+ * A location in the original source code.
+ *
+ * Locations are small enough to copy freely: they refer to their file via the
+ * @ref SourceFiles table and pack their line and column into 32 bits
+ * (lines and columns beyond what fits are clamped to the largest value).
+ */
+class SourceLocation
 {
 public:
 	SourceLocation(const std::string& filename = "",
 	               size_t line = 0, size_t column = 0);
 
+	SourceLocation(SourceFiles::ID, size_t line, size_t column);
+
+	SourceFiles::ID file() const { return file_; }
+	const std::string& filename() const;
+	size_t line() const { return position_ >> ColumnBits; }
+	size_t column() const { return position_ & ColumnMask; }
+
 	operator bool() const;
 	bool operator < (const SourceLocation&) const;
 	bool operator > (const SourceLocation&) const;
 	bool operator == (const SourceLocation&) const;
 	bool operator != (const SourceLocation&) const;
 
-	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
+	void PrettyPrint(Bytestream&, unsigned int indent = 0) const;
+	std::string str() const;
+
+private:
+	static const unsigned int ColumnBits = 12;
+	static const uint32_t ColumnMask = (1u << ColumnBits) - 1;
 
-	std::string filename;
-	size_t line;
-	size_t column;
+	//! A single integer that orders locations by file, line and column.
+	uint64_t key() const { return (uint64_t{file_} << 32) | position_; }
+
+	SourceFiles::ID file_;
+	uint32_t position_;
 };
 
+Bytestream& operator << (Bytestream&, const SourceLocation&);
+
 } // class fabrique
 
 #endif  // FAB_SOURCE_LOCATION_H_
@@ -36,18 +36,23 @@
 #ifndef FAB_SOURCE_RANGE_H_
 #define FAB_SOURCE_RANGE_H_
 
-#include <fabrique/Printable.hh>
 #include <fabrique/SourceLocation.hh>
 
 #include <string>
 
 namespace fabrique {
 
+class Bytestream;
 class HasSource;
 
 
-//! A range of characters in source code.
-class SourceRange : public Printable
+/**
+ * A range of characters in source code.
+ *
+ * A range is just two @ref SourceLocation values (16 B in total), so ranges
+ * can be copied and compared as cheaply as a pair of integers.
+ */
+class SourceRange
 {
 public:
 	static const SourceRange& None();
@@ -66,10 +71,21 @@ public:
 		const SourceRange& xsrc = x ? x->source() : nowhere;
 		const SourceRange& ysrc = y ? y->source() : nowhere;
 
-		const SourceRange& begin = (xsrc and xsrc < ysrc) ? xsrc : ysrc;
-		const SourceRange& end = (ysrc and xsrc < ysrc) ? ysrc : xsrc;
+		return Over(xsrc, ysrc);
+	}
+
+	//! Create the smallest range that covers two ranges.
+	static SourceRange Over(const SourceRange& x, const SourceRange& y)
+	{
+		if (not x)
+			return y;
+
+		if (not y)
+			return x;
 
-		return SourceRange(begin.begin, end.end);
+		return SourceRange(
+			y.begin < x.begin ? y.begin : x.begin,
+			y.end > x.end ? y.end : x.end);
 	}
 
 	//! Create a range over a map of @ref fabrique::HasSource objects.
@@ -105,16 +121,19 @@ public:
 
 	bool isInside(const SourceRange&) const;
 
-	std::string filename() const;
+	const std::string& filename() const;
 
 	Bytestream& PrintSource(Bytestream&, SourceLocation caret = SourceLocation(),
 	                        unsigned int contextLines = 3) const;
-	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
+	void PrettyPrint(Bytestream&, unsigned int indent = 0) const;
+	std::string str() const;
 
 	SourceLocation begin;
 	SourceLocation end;
 };
 
+Bytestream& operator << (Bytestream&, const SourceRange&);
+
 } // class fabrique
 
 #endif  // FAB_SOURCE_RANGE_H_
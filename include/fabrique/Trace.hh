@@ -0,0 +1,124 @@
+//! @file  Trace.hh    Declaration of fabrique::Trace
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_TRACE_H_
+#define FAB_TRACE_H_
+
+#include <chrono>
+#include <string>
+
+
+namespace fabrique {
+
+/**
+ * A timeline of nested spans (parsing a file, importing a module, etc.) recorded
+ * over a Fabrique run and written out in the Chrome trace event format
+ * (loadable by chrome://tracing or Perfetto).
+ *
+ * When tracing is disabled, creating a span costs a single test of a flag.
+ */
+class Trace
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * A timed span of work, recorded as a "complete" event when it ends.
+	 *
+	 * The span's name can be set after construction in order to avoid the cost
+	 * of computing names when tracing is disabled:
+	 *
+	 * ```
+	 * Trace::Span span("call");
+	 * if (span)
+	 *     span.setName(target.str());
+	 * ```
+	 */
+	class Span
+	{
+	public:
+		Span(const char *category)
+			: active_(Trace::enabled_), category_(category)
+		{
+			if (active_)
+			{
+				start_ = Clock::now();
+			}
+		}
+
+		Span(const char *category, const std::string &name)
+			: Span(category)
+		{
+			if (active_)
+			{
+				name_ = name;
+			}
+		}
+
+		~Span()
+		{
+			if (active_)
+			{
+				Trace::Record(category_, name_, start_, Clock::now());
+			}
+		}
+
+		//! Are we recording this span (i.e., is tracing enabled)?
+		explicit operator bool() const { return active_; }
+
+		void setName(std::string name) { name_ = std::move(name); }
+
+	private:
+		Span(const Span&) = delete;
+		Span& operator= (const Span&) = delete;
+
+		const bool active_;
+		const char *category_;
+		std::string name_;
+		Clock::time_point start_;
+	};
+
+	//! Start recording spans, to be written to @a filename by @ref Finish.
+	static void Enable(std::string filename);
+
+	//! Write all recorded spans to the trace file (if tracing is enabled).
+	static void Finish();
+
+private:
+	//! Record a completed span (safe to call from any thread).
+	static void Record(const char *category, const std::string &name,
+	                   Clock::time_point start, Clock::time_point end);
+
+	static bool enabled_;
+};
+
+} // namespace fabrique
+
+#endif  // FAB_TRACE_H_
@@ -0,0 +1,80 @@
+//! @file WorkerPool.hh    Declaration of @ref fabrique::WorkerPool
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_WORKER_POOL_H_
+#define FAB_WORKER_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace fabrique {
+
+/**
+ * A fixed set of threads that run submitted tasks in submission order.
+ *
+ * Destroying the pool discards tasks that have not yet started and waits for
+ * running tasks to finish.
+ */
+class WorkerPool
+{
+public:
+	using Task = std::function<void ()>;
+
+	//! Create a pool of @a threads workers (or one per core if zero).
+	WorkerPool(unsigned int threads = 0);
+	~WorkerPool();
+
+	//! How many worker threads are in this pool?
+	size_t size() const { return threads_.size(); }
+
+	//! Queue a task to be run on a worker thread (tasks must not throw).
+	void Submit(Task);
+
+private:
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator= (const WorkerPool&) = delete;
+
+	void Work();
+
+	std::vector<std::thread> threads_;
+	std::deque<Task> tasks_;
+	std::mutex lock_;
+	std::condition_variable ready_;
+	bool stopping_;
+};
+
+} // namespace fabrique
+
+#endif // FAB_WORKER_POOL_H_
@@ -56,12 +56,13 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
 	const UniqPtr<Identifier> name_;
-	const UniqPtr<Expression> value_;
+	UniqPtr<Expression> value_;
 };
 
 } // namespace ast
@@ -56,9 +56,10 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 private:
-	const UniqPtrVec<Expression> positional_;
+	UniqPtrVec<Expression> positional_;
 	const UniqPtrVec<Argument> keyword_;
 };
 
@@ -86,6 +86,7 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
@@ -93,8 +94,8 @@ private:
 	static const Type& ResultType(const Type& lhs, const Type& rhs,
                                       Operator, SourceRange&);
 
-	const std::unique_ptr<Expression> lhs_;
-	const std::unique_ptr<Expression> rhs_;
+	std::unique_ptr<Expression> lhs_;
+	std::unique_ptr<Expression> rhs_;
 	const Operator op_;
 };
 
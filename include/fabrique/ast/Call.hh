@@ -52,15 +52,26 @@ public:
 	Call(UniqPtr<Expression> target, UniqPtr<Arguments> arguments, SourceRange);
 
 	const Expression& target() const { return *target_; }
+	const Arguments& arguments() const { return *arguments_; }
+
+	/**
+	 * Has @ref TypeChecker proven that this call's arguments match the
+	 * parameters of the function being called? If so, evaluation needn't
+	 * check them again.
+	 */
+	bool argumentsChecked() const { return argumentsChecked_; }
+	void setArgumentsChecked() const { argumentsChecked_ = true; }
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const UniqPtr<Expression> target_;
+	UniqPtr<Expression> target_;
 	const UniqPtr<Arguments> arguments_;
+	mutable bool argumentsChecked_;
 };
 
 } // namespace ast
@@ -50,16 +50,18 @@ public:
 	CompoundExpression(UniqPtrVec<Value> values, UniqPtr<Expression> result,
 	                   SourceRange);
 
+	const UniqPtrVec<Value>& values() const { return values_; }
 	const Expression& result() const { return *result_; }
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
 	const UniqPtrVec<Value> values_;
-	const UniqPtr<Expression> result_;
+	UniqPtr<Expression> result_;
 };
 
 } // namespace ast
@@ -58,13 +58,14 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const std::unique_ptr<Expression> condition_;
-	const std::unique_ptr<Expression> thenClause_;
-	const std::unique_ptr<Expression> elseClause_;
+	std::unique_ptr<Expression> condition_;
+	std::unique_ptr<Expression> thenClause_;
+	std::unique_ptr<Expression> elseClause_;
 };
 
 } // namespace ast
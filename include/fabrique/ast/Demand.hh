@@ -0,0 +1,95 @@
+//! @file ast/Demand.hh    Declaration of @ref fabrique::ast::Demand
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_AST_DEMAND_H_
+#define FAB_AST_DEMAND_H_
+
+#include <fabrique/PtrVec.hh>
+#include <fabrique/ast/Visitor.hh>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+namespace fabrique {
+namespace ast {
+
+/**
+ * Finds the top-level values that some requested values depend on.
+ *
+ * A value depends on every top-level value that it names, whether directly
+ * or from within a nested function, record, etc. This is conservative:
+ * a local name that shadows a top-level value counts as a reference to it.
+ * Unnamed values and values that configure evaluation itself (`subdir` and
+ * `builddir`, which builtins look up by name) are always demanded.
+ *
+ * So are values that might create builds (i.e., that call anything but a
+ * few builtins), since other values can depend on the files that those
+ * builds generate by filename alone (e.g., `file('gen.h', generated = true)`).
+ *
+ * Evaluating only the demanded values, in their original order, produces
+ * the same DAG for the requested values as evaluating everything would.
+ */
+class Demand : public Visitor
+{
+public:
+	Demand();
+
+	/**
+	 * Which of a file's top-level values are needed to evaluate the
+	 * requested ones?
+	 *
+	 * @returns   a flag for each value in @a values
+	 */
+	std::vector<bool> Demanded(const UniqPtrVec<Value>& values,
+	                           const std::vector<std::string>& requested);
+
+	bool Enter(const Call&) override;
+	bool Enter(const Function&) override;
+	void Leave(const Function&) override;
+	bool Enter(const NameReference&) override;
+	bool Enter(const SimpleTypeReference&) override;
+
+private:
+	//! Names referred to by the value currently being visited.
+	std::unordered_set<std::string> names_;
+
+	//! Might the value currently being visited create builds?
+	bool mayBuild_;
+
+	//! How many function definitions are we currently inside?
+	unsigned int functionDepth_;
+};
+
+} // namespace ast
+} // namespace fabrique
+
+#endif // FAB_AST_DEMAND_H_
@@ -33,6 +33,7 @@
 #ifndef EVAL_CONTEXT_H
 #define EVAL_CONTEXT_H
 
+#include <fabrique/ast/Address.hh>
 #include <fabrique/dag/DAG.hh>
 #include <fabrique/dag/DAGBuilder.hh>
 #include <fabrique/dag/Record.hh>
@@ -49,6 +50,7 @@ class CLIArguments;
 class FileType;
 class FunctionType;
 class TypeContext;
+class WorkerPool;
 
 namespace dag {
 class Build;
@@ -70,7 +72,24 @@ class Value;
 class EvalContext : public dag::DAGBuilder::Context
 {
 public:
-	EvalContext(TypeContext& ctx);
+	/**
+	 * Create a context for evaluating code on the current thread.
+	 *
+	 * @param   workers      threads that independent parts of the code
+	 *                       (e.g., @ref ForeachExpr bodies) may be
+	 *                       evaluated on, or null to evaluate serially
+	 */
+	EvalContext(TypeContext& ctx, WorkerPool *workers = nullptr);
+
+	/**
+	 * Create a context for evaluating code speculatively on behalf of another
+	 * context (e.g., importing a module on a worker thread).
+	 *
+	 * @param   valueNames   the names of the values that the other context
+	 *                       will be defining when it would evaluate the code
+	 */
+	EvalContext(TypeContext& ctx, std::deque<std::string> valueNames);
+
 	~EvalContext() override {}
 
 	std::vector<dag::DAG::BuildTarget> Evaluate(const UniqPtrVec<Value>&);
@@ -87,6 +106,10 @@ public:
 	 * keeps its parent Scope around via shared pointer as long as it exists. This
 	 * allows us to retain a Scope for evaluating functions and build actions, both
 	 * of which can capture values from their lexical scope.
+	 *
+	 * Values whose names were resolved ahead of time (see @ref Resolver) are
+	 * also stored in numbered slots, so that references to them need not
+	 * search through each enclosing scope's names.
 	 */
 	class ScopedValues : public Printable
 	{
@@ -100,17 +123,27 @@ public:
 		//! Define a name within a scope
 		ScopedValues& Define(const std::string &name, dag::ValuePtr,
 		                     SourceRange = SourceRange::None(),
-		                     bool allowReservedName = false);
+		                     bool allowReservedName = false,
+		                     Slot = NoSlot);
 
 		//! Look up a given name in this scope or its parents
 		dag::ValuePtr Lookup(const std::string &name) const;
 
+		/**
+		 * Look up a value by lexical address.
+		 *
+		 * @returns   the value, or nullptr if the addressed slot has not
+		 *            (yet) been defined
+		 */
+		dag::ValuePtr Lookup(Address) const;
+
 		virtual void PrettyPrint(Bytestream&, unsigned int) const override;
 
 	private:
 		const std::string name_;
 		const std::shared_ptr<ScopedValues> parent_;
 		dag::ValueMap values_;
+		std::vector<dag::ValuePtr> slots_;
 	};
 
 	/**
@@ -132,7 +165,7 @@ public:
 
 		//! Define a name within a scope
 		Scope& Define(const std::string &name, dag::ValuePtr,
-		              SourceRange = SourceRange::None());
+		              SourceRange = SourceRange::None(), Slot = NoSlot);
 
 		//! Define a language-reserved name within a scope
 		Scope& DefineReserved(const std::string &name, dag::ValuePtr);
@@ -165,6 +198,19 @@ public:
 	dag::DAGBuilder& builder() { return builder_; }
 
 	virtual std::string currentValueName() const override;
+
+	//! The names of the values currently being defined (outermost first).
+	const std::deque<std::string>& valueNames() const { return currentValueName_; }
+
+	/**
+	 * Is this context evaluating speculatively? Speculative evaluation may
+	 * be thrown away, so it must not have effects outside of the DAG.
+	 */
+	bool speculative() const { return speculative_; }
+
+	//! Worker threads that evaluation can use (null if none are available).
+	WorkerPool* workers() const { return workers_; }
+
 	virtual TypeContext& types() const override { return ctx_; }
 
 	//! Define an ast::Value in the current scope
@@ -173,9 +219,15 @@ public:
 	//! Look up a named value from the current scope or a parent scope.
 	dag::ValuePtr Lookup(const std::string& name, SourceRange = SourceRange::None());
 
+	/**
+	 * Look up a value by its lexical address, falling back to a lookup by
+	 * name if the addressed slot has not been defined.
+	 */
+	dag::ValuePtr Lookup(const std::string& name, Address, SourceRange);
+
 private:
 	//! Define a named value in the current scope
-	dag::ValuePtr Define(std::string, dag::ValuePtr);
+	dag::ValuePtr Define(std::string, dag::ValuePtr, Slot = NoSlot);
 
 	std::shared_ptr<ScopedValues> PopScope();
 
@@ -193,6 +245,9 @@ private:
 	/** The name of the value we are currently processing. */
 	std::deque<std::string> currentValueName_;
 
+	const bool speculative_;
+	WorkerPool *workers_;
+
 	dag::DAGBuilder builder_;
 };
 
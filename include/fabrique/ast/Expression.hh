@@ -40,6 +40,8 @@
 
 namespace fabrique {
 
+class Type;
+
 namespace ast {
 
 class EvalContext;
@@ -58,28 +60,47 @@ public:
 	std::shared_ptr<T> evaluateAs(EvalContext &ctx,
 	                              SourceRange src = SourceRange::None())
 	{
-		const std::string typeName = platform::TypeName(*this);
 		if (not src)
 		{
 			src = source();
 		}
 
+		// Demangling type names is expensive, so only build error
+		// messages if there is actually an error to report.
 		auto plainValue = evaluate(ctx);
-		SemaCheck(plainValue, src, "error evaluating " + typeName);
+		if (not plainValue)
+		{
+			throw SemanticException("error evaluating "
+				+ platform::TypeName(*this), src);
+		}
 
 		auto asSubtype = std::dynamic_pointer_cast<T>(plainValue);
-		SemaCheck(asSubtype, src,
-			platform::TypeName(*plainValue) + " (evaluated from " + typeName
-			+ ") is not a " + platform::Demangle(typeid(T)));
+		if (not asSubtype)
+		{
+			throw SemanticException(
+				platform::TypeName(*plainValue) + " (evaluated from "
+				+ platform::TypeName(*this) + ") is not a "
+				+ platform::Demangle(typeid(T)), src);
+		}
 
 		return asSubtype;
 	}
 
+	/**
+	 * The type that @ref TypeChecker has proven this expression's value
+	 * will have (or a supertype of it), or null if it isn't known statically.
+	 */
+	const Type* staticType() const { return staticType_; }
+	void setStaticType(const Type &t) const { staticType_ = &t; }
+
 protected:
 	Expression(const SourceRange& src)
-		: Node(src)
+		: Node(src), staticType_(nullptr)
 	{
 	}
+
+private:
+	mutable const Type *staticType_;
 };
 
 typedef PtrVec<Expression> ExprVec;
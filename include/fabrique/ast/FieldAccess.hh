@@ -35,6 +35,8 @@
 #include <fabrique/UniqPtr.hh>
 #include <fabrique/ast/Expression.hh>
 
+#include <atomic>
+
 namespace fabrique {
 namespace ast {
 
@@ -55,12 +57,19 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const UniqPtr<Expression> base_;
+	UniqPtr<Expression> base_;
 	const UniqPtr<Identifier> field_;
+
+	/**
+	 * The record shape that we last found the field in, together with
+	 * the field's offset within that shape.
+	 */
+	mutable std::atomic<uint64_t> cachedShape_;
 };
 
 } // namespace ast
@@ -56,13 +56,14 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const UniqPtr<Expression> base_;
+	UniqPtr<Expression> base_;
 	const UniqPtr<Identifier> field_;
-	const UniqPtr<Expression> defaultValue_;
+	UniqPtr<Expression> defaultValue_;
 };
 
 } // namespace ast
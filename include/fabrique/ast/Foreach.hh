@@ -33,9 +33,15 @@
 #define FOREACH_H
 
 #include <fabrique/ast/CompoundExpr.hh>
+#include <fabrique/ast/EvalContext.hh>
 #include <fabrique/ast/TypeReference.hh>
 
 namespace fabrique {
+
+namespace dag {
+class List;
+}
+
 namespace ast {
 
 class Parameter;
@@ -44,6 +50,14 @@ class Value;
 
 /**
  * An expression that maps list elements into another list.
+ *
+ * When worker threads are available, the body of a foreach over a long list
+ * is evaluated for several elements at once. The results (including any
+ * rules, builds and files) are combined in element order, so the result is
+ * the same as evaluating each element in turn. If the body has effects that
+ * depend on the order of evaluation (e.g., printing, importing or generating
+ * a file defined outside of the loop), the parallel results are discarded
+ * and the elements are evaluated in turn.
  */
 class ForeachExpr : public Expression
 {
@@ -52,19 +66,40 @@ public:
 	            UniqPtr<Expression> inputValue, UniqPtr<Expression> body,
 	            SourceRange);
 
+	const Identifier& loopVariable() const { return *loopVarName_; }
 	const Expression& sourceSequence() const { return *inputValue_; }
 	const Expression& loopBody() const { return *body_; }
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
+	/**
+	 * Evaluate the loop body with a list element as the loop variable.
+	 *
+	 * @param   parentScope    the scope surrounding the loop (if it isn't
+	 *                         the context's current scope)
+	 */
+	dag::ValuePtr EvaluateBody(const dag::ValuePtr& element, EvalContext&,
+	                           std::shared_ptr<EvalContext::ScopedValues>
+	                             parentScope = nullptr) const;
+
+	/**
+	 * Evaluate the loop body for every list element on worker threads.
+	 *
+	 * @returns   whether parallel evaluation succeeded (if not, @a ctx
+	 *            has not been modified)
+	 */
+	bool EvaluateInParallel(const dag::List&, EvalContext& ctx,
+	                        SharedPtrVec<dag::Value>& results) const;
+
 	const UniqPtr<Identifier> loopVarName_;
 	const UniqPtr<TypeReference> explicitType_;
-	const UniqPtr<Expression> inputValue_;
-	const UniqPtr<Expression> body_;
+	UniqPtr<Expression> inputValue_;
+	UniqPtr<Expression> body_;
 };
 
 } // namespace ast
@@ -51,16 +51,28 @@ public:
 	Function(UniqPtrVec<Parameter> params, UniqPtr<TypeReference> resultType,
 	         UniqPtr<Expression> body, SourceRange);
 
+	const UniqPtr<TypeReference>& resultType() const { return resultType_; }
 	const Expression& body() const { return *body_; }
 
+	/**
+	 * Is this function free of side effects? A pure function does not
+	 * define actions or files and does not call `file`, `import` or
+	 * `print` directly, so calls to it can be memoized (subject to the
+	 * functions it calls also being free of side effects). Named values
+	 * within its body are replayed under the caller's name on each call.
+	 */
+	bool pure() const { return pure_; }
+
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
 	const UniqPtr<TypeReference> resultType_;
-	const UniqPtr<Expression> body_;
+	UniqPtr<Expression> body_;
+	const bool pure_;
 };
 
 } // namespace ast
@@ -56,11 +56,12 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const UniqPtrVec<Expression> elements_;
+	UniqPtrVec<Expression> elements_;
 };
 
 } // namespace ast
@@ -34,6 +34,7 @@
 
 #include <fabrique/PtrVec.hh>
 
+#include <fabrique/ast/Address.hh>
 #include <fabrique/ast/Argument.hh>
 #include <fabrique/ast/Expression.hh>
 
@@ -53,6 +54,13 @@ public:
 
 	const Identifier& name() const { return *name_; }
 
+	/**
+	 * The lexical address of the referenced value, if it has been resolved
+	 * by @ref Resolver. Unresolved names are looked up by name.
+	 */
+	const Address* address() const { return resolved_ ? &address_ : nullptr; }
+	void resolve(Address a) const { address_ = a; resolved_ = true; }
+
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
 
@@ -60,6 +68,8 @@ public:
 
 private:
 	const UniqPtr<Identifier> name_;
+	mutable Address address_;
+	mutable bool resolved_;
 };
 
 } // namespace ast
@@ -37,9 +37,13 @@
 #include <fabrique/Uncopyable.hh>
 #include <fabrique/Visitable.hh>
 
+#include <functional>
+#include <memory>
+
 namespace fabrique {
 namespace ast {
 
+class Expression;
 class Visitor;
 
 /**
@@ -51,6 +55,15 @@ class Node : public HasSource, public Printable, public Visitable<Visitor>,
 public:
 	virtual ~Node();
 
+	//! Something that may replace an expression (see @ref Optimizer).
+	using Rewriter = std::function<void (std::unique_ptr<Expression>&)>;
+
+	/**
+	 * Give a @ref Rewriter the chance to replace each of this node's
+	 * immediate subexpressions (but not the node itself).
+	 */
+	virtual void RewriteSubexpressions(const Rewriter&);
+
 protected:
 	Node(const SourceRange& src) : HasSource(src) {}
 };
@@ -0,0 +1,172 @@
+//! @file ast/Optimizer.hh    Declaration of @ref fabrique::ast::Optimizer
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_AST_OPTIMIZER_H_
+#define FAB_AST_OPTIMIZER_H_
+
+#include <fabrique/PtrVec.hh>
+#include <fabrique/UniqPtr.hh>
+#include <fabrique/dag/Value.hh>
+
+
+namespace fabrique {
+
+class TypeContext;
+
+namespace ast {
+
+class EvalContext;
+class Expression;
+class Value;
+
+
+/**
+ * A pass that simplifies expressions (see @ref Optimizer).
+ */
+class OptimizationPass
+{
+public:
+	virtual ~OptimizationPass();
+
+	//! A short name for this pass (e.g., for debug output).
+	virtual const char* name() const = 0;
+
+	/**
+	 * Simplify an expression whose subexpressions have already been
+	 * simplified.
+	 *
+	 * @returns   whether @a e was replaced
+	 */
+	virtual bool Rewrite(UniqPtr<Expression>& e) = 0;
+};
+
+
+/**
+ * Runs a pipeline of @ref OptimizationPass objects over an AST.
+ *
+ * Optimization happens after an AST has been resolved and type-checked but
+ * before it is evaluated. Expressions are rewritten from the bottom up: each
+ * pass (in order) gets to rewrite an expression after its subexpressions
+ * have been rewritten, so nested simplifications happen in one traversal.
+ *
+ * Passes must not change what an expression evaluates to. Since names have
+ * already been resolved to lexical addresses, passes may remove scopes or
+ * name references but they may not introduce them.
+ */
+class Optimizer
+{
+public:
+	//! Add a pass to the end of the pipeline.
+	Optimizer& Add(UniqPtr<OptimizationPass>);
+
+	/**
+	 * Add passes that can be applied to any AST: constant folding,
+	 * short-circuiting and dead-branch elimination.
+	 */
+	Optimizer& AddStandardPasses(TypeContext&);
+
+	//! Optimize the expressions that define some values.
+	void Optimize(const UniqPtrVec<Value>&);
+
+private:
+	void Rewrite(UniqPtr<Expression>&);
+
+	UniqPtrVec<OptimizationPass> passes_;
+};
+
+
+/**
+ * Evaluates operations on literals ahead of time (e.g., `1 + 2`,
+ * `'foo' + '.c'` or `2 == 3`).
+ *
+ * Operations that fail (e.g., division by zero) are left for evaluation
+ * to report.
+ */
+class ConstantFolding : public OptimizationPass
+{
+public:
+	ConstantFolding(TypeContext&);
+	~ConstantFolding() override;
+
+	const char* name() const override { return "constant-folding"; }
+	bool Rewrite(UniqPtr<Expression>&) override;
+
+private:
+	UniqPtr<EvalContext> ctx_;
+};
+
+
+/**
+ * Simplifies `and` and `or` operations whose left-hand side is a literal:
+ * `false and x` is `false`, while `true and x` is `x`.
+ */
+class ShortCircuit : public OptimizationPass
+{
+public:
+	const char* name() const override { return "short-circuit"; }
+	bool Rewrite(UniqPtr<Expression>&) override;
+};
+
+
+/**
+ * Replaces conditionals whose condition is a literal with the clause that
+ * would be evaluated.
+ */
+class DeadBranchElimination : public OptimizationPass
+{
+public:
+	const char* name() const override { return "dead-branch-elimination"; }
+	bool Rewrite(UniqPtr<Expression>&) override;
+};
+
+
+/**
+ * Replaces fields of the `args` record with the (boolean, integer or string)
+ * arguments that are known before evaluation, e.g., `-D debug=true`.
+ *
+ * This is only valid for the top-level file: a module can be imported
+ * with different arguments each time.
+ */
+class ArgumentPropagation : public OptimizationPass
+{
+public:
+	ArgumentPropagation(const dag::ValueMap& arguments);
+
+	const char* name() const override { return "argument-propagation"; }
+	bool Rewrite(UniqPtr<Expression>&) override;
+
+private:
+	const dag::ValueMap &arguments_;
+};
+
+} // namespace ast
+} // namespace fabrique
+
+#endif // FAB_AST_OPTIMIZER_H_
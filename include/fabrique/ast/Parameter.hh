@@ -58,6 +58,7 @@ public:
 	          UniqPtr<Expression> e = nullptr);
 
 	const Identifier& getName() const { return *name_; }
+	const UniqPtr<TypeReference>& type() const { return type_; }
 	const UniqPtr<Expression>& defaultValue() const
 	{
 		return defaultValue_;
@@ -48,8 +48,11 @@ class Record : public Expression
 public:
 	Record(UniqPtrVec<Value> fields, SourceRange);
 
+	const UniqPtrVec<Value>& fields() const { return fields_; }
+
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
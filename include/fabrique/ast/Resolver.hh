@@ -0,0 +1,86 @@
+//! @file ast/Resolver.hh    Declaration of @ref fabrique::ast::Resolver
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_AST_RESOLVER_H_
+#define FAB_AST_RESOLVER_H_
+
+#include <fabrique/PtrVec.hh>
+#include <fabrique/StringMap.hh>
+#include <fabrique/ast/Address.hh>
+#include <fabrique/ast/Visitor.hh>
+
+#include <vector>
+
+
+namespace fabrique {
+namespace ast {
+
+/**
+ * Resolves name references to lexical addresses ahead of evaluation.
+ *
+ * Names bound within a file (top-level values, values within compound
+ * expressions and records, function parameters and foreach loop variables)
+ * are given a (depth, slot) address that mirrors the scopes that
+ * @ref EvalContext creates at evaluation time. Other names (builtins,
+ * reserved names and anything defined by an importing file) are left alone
+ * to be looked up by name.
+ */
+class Resolver : public Visitor
+{
+public:
+	//! Resolve the names used by a file's top-level values.
+	void Resolve(const UniqPtrVec<Value>&);
+
+	bool Enter(const CompoundExpression&) override;
+	bool Enter(const FileList&) override;
+	bool Enter(const ForeachExpr&) override;
+	bool Enter(const Function&) override;
+	bool Enter(const NameReference&) override;
+	bool Enter(const Record&) override;
+
+private:
+	//! The names bound within a lexical scope and their slots.
+	using LexicalScope = StringMap<Slot>;
+
+	/**
+	 * Enter a new scope that binds the names of a sequence of values
+	 * and resolve the names used within those values.
+	 *
+	 * The caller is responsible for popping the scope.
+	 */
+	void EnterScope(const UniqPtrVec<Value>&);
+
+	std::vector<LexicalScope> scopes_;
+};
+
+} // namespace ast
+} // namespace fabrique
+
+#endif // FAB_AST_RESOLVER_H_
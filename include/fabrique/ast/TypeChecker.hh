@@ -0,0 +1,142 @@
+//! @file ast/TypeChecker.hh    Declaration of @ref fabrique::ast::TypeChecker
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_AST_TYPE_CHECKER_H_
+#define FAB_AST_TYPE_CHECKER_H_
+
+#include <fabrique/PtrVec.hh>
+#include <fabrique/ast/Visitor.hh>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace fabrique {
+
+class Type;
+class TypeContext;
+
+namespace ast {
+
+class TypeReference;
+
+/**
+ * Infers the static types of expressions ahead of evaluation.
+ *
+ * Each expression whose type can be known without evaluating anything is
+ * annotated with that type (or a supertype of it, e.g., for references to
+ * function parameters). Explicitly-typed values and calls to user-defined
+ * functions whose types check statically are marked so that evaluation
+ * can skip re-checking them. Type errors that evaluation would certainly
+ * report are reported here instead, even in code that is never evaluated.
+ *
+ * This pass relies on names having been resolved by @ref Resolver, and it
+ * mirrors the lexical scopes that the @ref Resolver uses.
+ */
+class TypeChecker : public Visitor
+{
+public:
+	TypeChecker(TypeContext&);
+
+	//! Check the top-level values of a file.
+	void Check(const UniqPtrVec<Value>&);
+
+	bool Enter(const CompoundExpression&) override;
+	bool Enter(const FileList&) override;
+	bool Enter(const ForeachExpr&) override;
+	bool Enter(const Function&) override;
+	bool Enter(const Record&) override;
+
+	void Leave(const BinaryOperation&) override;
+	void Leave(const BoolLiteral&) override;
+	void Leave(const Call&) override;
+	void Leave(const CompoundExpression&) override;
+	void Leave(const Conditional&) override;
+	void Leave(const FieldAccess&) override;
+	void Leave(const FilenameLiteral&) override;
+	void Leave(const ForeachExpr&) override;
+	void Leave(const Function&) override;
+	void Leave(const IntLiteral&) override;
+	void Leave(const List&) override;
+	void Leave(const NameReference&) override;
+	void Leave(const Record&) override;
+	void Leave(const StringLiteral&) override;
+	void Leave(const UnaryOperation&) override;
+	void Leave(const Value&) override;
+
+private:
+	//! What we know statically about a name bound in a lexical scope.
+	struct Binding
+	{
+		const Type *type = nullptr;
+		bool exact = false;
+
+		//! The function literal that the name is bound to (if any).
+		const Function *function = nullptr;
+	};
+
+	using LexicalScope = std::vector<Binding>;
+
+	void EnterScope(const UniqPtrVec<Value>&);
+	const Binding* Lookup(const NameReference&) const;
+
+	/**
+	 * Record the static type of an expression.
+	 *
+	 * @param   exact     the expression's value will have exactly this
+	 *                    type rather than (possibly) a subtype of it
+	 */
+	void SetType(const Expression&, const Type&, bool exact);
+	bool Exact(const Expression&) const;
+
+	//! Resolve a type reference without evaluating it (null if we can't).
+	const Type* Resolve(const TypeReference&);
+
+	//! The user-defined function that an expression refers to (if any).
+	const Function* FunctionOf(const Expression&) const;
+
+	/**
+	 * Check the arguments to a call to a user-defined function.
+	 *
+	 * @returns   whether the arguments are known to match the parameters
+	 */
+	bool CheckArguments(const Call&, const Function&);
+
+	TypeContext &types_;
+	std::vector<LexicalScope> scopes_;
+	std::unordered_set<const Expression*> exact_;
+	std::unordered_map<const TypeReference*, const Type*> resolved_;
+};
+
+} // namespace ast
+} // namespace fabrique
+
+#endif // FAB_AST_TYPE_CHECKER_H_
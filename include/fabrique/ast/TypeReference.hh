@@ -56,6 +56,8 @@ class SimpleTypeReference : public TypeReference
 public:
 	SimpleTypeReference(UniqPtr<Identifier> name, SourceRange);
 
+	const Identifier& name() const { return *name_; }
+
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 	virtual void Accept(Visitor&) const override;
@@ -79,6 +81,9 @@ public:
 	ParametricTypeReference(UniqPtr<TypeReference> base, SourceRange,
 	                        UniqPtrVec<TypeReference> parameters);
 
+	const TypeReference& base() const { return *base_; }
+	const UniqPtrVec<TypeReference>& parameters() const { return parameters_; }
+
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 	virtual void Accept(Visitor&) const override;
@@ -103,6 +108,9 @@ public:
 	FunctionTypeReference(UniqPtrVec<TypeReference> params,
 	                      UniqPtr<TypeReference> result, SourceRange);
 
+	const UniqPtrVec<TypeReference>& parameters() const { return parameters_; }
+	const TypeReference& resultType() const { return *resultType_; }
+
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 	virtual void Accept(Visitor&) const override;
@@ -126,6 +134,8 @@ class RecordTypeReference : public TypeReference
 public:
 	RecordTypeReference(NamedPtrVec<TypeReference>, SourceRange);
 
+	const NamedPtrVec<TypeReference>& fields() const { return fieldTypes_; }
+
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 	virtual void Accept(Visitor&) const override;
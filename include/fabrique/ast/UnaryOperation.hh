@@ -70,11 +70,12 @@ public:
 
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
-	const UniqPtr<Expression> subexpr_;
+	UniqPtr<Expression> subexpr_;
 	const Operator op_;
 };
 
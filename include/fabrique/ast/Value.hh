@@ -32,6 +32,7 @@
 #ifndef AST_VALUE_H
 #define AST_VALUE_H
 
+#include <fabrique/ast/Address.hh>
 #include <fabrique/ast/Identifier.hh>
 #include <fabrique/ast/TypeReference.hh>
 
@@ -51,15 +52,29 @@ public:
 	const UniqPtr<TypeReference>& explicitType() const { return explicitType_; }
 	const Expression& value() const { return *value_; }
 
+	//! The slot this value occupies within its lexical scope (if named).
+	Slot slot() const { return slot_; }
+	void setSlot(Slot s) const { slot_ = s; }
+
+	/**
+	 * Has @ref TypeChecker proven that this value satisfies its explicit
+	 * type? If so, evaluation needn't check it again.
+	 */
+	bool explicitTypeChecked() const { return typeChecked_; }
+	void setExplicitTypeChecked() const { typeChecked_ = true; }
+
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 	virtual void Accept(Visitor&) const override;
+	virtual void RewriteSubexpressions(const Rewriter&) override;
 
 	virtual dag::ValuePtr evaluate(EvalContext&) const override;
 
 private:
 	const UniqPtr<Identifier> name_;
 	const UniqPtr<TypeReference> explicitType_;
-	const UniqPtr<Expression> value_;
+	UniqPtr<Expression> value_;
+	mutable Slot slot_;
+	mutable bool typeChecked_;
 };
 
 } // namespace ast
@@ -37,6 +37,8 @@
 
 namespace fabrique {
 
+class WorkerPool;
+
 namespace ast {
 class EvalContext;
 }
@@ -68,9 +70,12 @@ dag::ValuePtr Fields(dag::DAGBuilder&);
  * @param     loader       object that can load plugins that have not been loaded yet
  *                         (lifetime must exceed the value returned by this function)
  * @param     srcroot      root directory containing all source files (absolute path)
+ * @param     workers      threads that may speculatively evaluate subdirectory
+ *                         imports ahead of the calls that need them
+ *                         (lifetime must exceed the value returned by this function)
  */
 dag::ValuePtr Import(parsing::Parser &parser, plugin::Loader &loader, std::string srcroot,
-                     ast::EvalContext&);
+                     ast::EvalContext&, WorkerPool *workers = nullptr);
 
 /**
  * Create implementation of Fabrique `print()` function
@@ -0,0 +1,104 @@
+//! @file Adjacency.hh    Declaration of @ref fabrique::dag::Adjacency
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DAG_ADJACENCY_H
+#define DAG_ADJACENCY_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace fabrique {
+namespace dag {
+
+/**
+ * A graph's edges, stored as a compressed sparse row (CSR) adjacency array.
+ *
+ * Nodes are identified by dense integer IDs. Node n's neighbours are stored
+ * contiguously, so looking them up is a pair of array accesses and walking
+ * the whole graph is linear in its number of edges.
+ */
+class Adjacency
+{
+public:
+	//! Identifies a node in the graph.
+	using ID = uint32_t;
+
+	//! An ID that doesn't refer to any node.
+	static const ID None = UINT32_MAX;
+
+	using Edges = std::vector<std::pair<ID,ID>>;
+
+	//! The IDs adjacent to a node, in a contiguous run of memory.
+	class Range
+	{
+	public:
+		Range(const ID *begin, const ID *end) : begin_(begin), end_(end) {}
+
+		const ID* begin() const { return begin_; }
+		const ID* end() const { return end_; }
+		size_t size() const { return static_cast<size_t>(end_ - begin_); }
+		bool empty() const { return begin_ == end_; }
+
+	private:
+		const ID *begin_;
+		const ID *end_;
+	};
+
+	Adjacency() {}
+
+	/**
+	 * Construct from (from, to) pairs.
+	 *
+	 * Edges from the same node keep their relative order.
+	 */
+	Adjacency(size_t nodes, const Edges &edges);
+
+	Range operator[] (ID node) const;
+
+	//! The number of nodes in the graph.
+	size_t nodes() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+	//! The number of edges in the graph.
+	size_t size() const { return edges_.size(); }
+
+	//! The same graph with every edge reversed.
+	Adjacency Transpose(size_t nodes) const;
+
+private:
+	std::vector<ID> offsets_;
+	std::vector<ID> edges_;
+};
+
+} // namespace dag
+} // namespace fabrique
+
+#endif
@@ -59,8 +59,8 @@ public:
 
 	const Rule& buildRule() const { return *rule_; }
 
-	const FileVec inputs() const { return in_; }
-	const FileVec outputs() const { return out_; }
+	const FileVec& inputs() const { return in_; }
+	const FileVec& outputs() const { return out_; }
 
 	const ValueMap& arguments() const { return args_; }
 
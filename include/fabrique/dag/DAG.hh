@@ -44,6 +44,7 @@ namespace fabrique {
 namespace dag {
 
 class Build;
+class DAGIndex;
 class File;
 class Rule;
 
@@ -65,6 +66,19 @@ public:
 	//! A file's top-level targets, in order of original definition.
 	virtual const std::vector<BuildTarget>& topLevelTargets() const = 0;
 
+	//! Dense indices of which builds produce and consume which files, etc.
+	virtual const DAGIndex& index() const = 0;
+
+	/**
+	 * Check that the DAG is well-formed: no file may be produced by more
+	 * than one build and no build may (transitively) depend on itself.
+	 *
+	 * This takes time linear in the size of the DAG.
+	 *
+	 * @throws SemanticException pointing at the offending build(s)
+	 */
+	void Validate() const;
+
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 };
 
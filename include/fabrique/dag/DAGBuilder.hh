@@ -38,6 +38,8 @@
 #include <fabrique/dag/Value.hh>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace fabrique {
@@ -74,11 +76,94 @@ public:
 	DAGBuilder(Context&);
 
 
-	//! Construct a @ref DAG from the current @ref DAGBuilder state.
-	UniqPtr<DAG> dag(std::vector<std::string> topLevelTargets) const;
+	/**
+	 * Construct a @ref DAG from the current @ref DAGBuilder state.
+	 *
+	 * @param   validate     check the DAG for cycles and for files produced
+	 *                       by more than one build (see @ref DAG::Validate)
+	 * @param   only         if non-empty, only include these top-level
+	 *                       targets and whatever is required to build them
+	 *                       (as well as regeneration of the build description)
+	 */
+	UniqPtr<DAG> dag(std::vector<std::string> topLevelTargets,
+	                 bool validate = true,
+	                 const std::vector<std::string>& only = {}) const;
 
 	TypeContext& typeContext() { return ctx_.types(); }
 
+	//! The context that supplies this builder with names and types.
+	Context& context() { return ctx_; }
+
+	/**
+	 * Take everything that another builder has built (e.g., while evaluating
+	 * a module on another thread), as if it had been built here.
+	 *
+	 * Files and builds are appended, rules replace any previous rules of the
+	 * same name and names that have already been defined keep their values,
+	 * just as if the other builder's operations had been performed here.
+	 */
+	void Merge(DAGBuilder&&);
+
+	/**
+	 * The number of side effects (definitions, builds, files and rules)
+	 * recorded so far: evaluation that leaves this count unchanged has not
+	 * modified the DAG under construction.
+	 */
+	size_t effects() const { return effects_; }
+
+	/**
+	 * The number of side effects that happened outside of the DAG (e.g.,
+	 * printing). These can't be reproduced from generated outputs.
+	 */
+	size_t externalEffects() const { return externalEffects_; }
+
+	//! Record a side effect that happens outside of the DAG (e.g., printing).
+	void NoteEffect() { effects_++; externalEffects_++; }
+
+	//! Definitions (fully-qualified names and values), in the order they were made.
+	using DefinitionLog = std::vector<std::pair<std::string, ValuePtr>>;
+
+	/**
+	 * Start appending every definition to a log (or stop, if passed null),
+	 * e.g., so that a memoized evaluation can replay its definitions.
+	 *
+	 * @returns   the previously-installed log (if any)
+	 */
+	DefinitionLog* LogDefinitions(DefinitionLog *log)
+	{
+		std::swap(log, definitionLog_);
+		return log;
+	}
+
+	/**
+	 * Logs the definitions that a @ref DAGBuilder makes while this object
+	 * exists. Logs nest: an enclosing log also receives our definitions.
+	 */
+	class DefinitionRecorder
+	{
+	public:
+		DefinitionRecorder(DAGBuilder&);
+		~DefinitionRecorder();
+
+		const DefinitionLog& log() const { return log_; }
+
+		/**
+		 * Name the logged definitions relative to a prefix (e.g., the
+		 * name of the value that was being evaluated when they were made).
+		 *
+		 * @returns   false if any definition is not named under the prefix
+		 */
+		bool Relative(const std::string &prefix, DefinitionLog &out) const;
+
+	private:
+		DAGBuilder &builder_;
+		DefinitionLog log_;
+		DefinitionLog *outer_;
+	};
+
+	//! Define values that are named relative to a prefix (e.g., to replay a log).
+	void Define(const std::string &prefix, const DefinitionLog&);
+
 
 	//! Define a variable with a name and a value.
 	void Define(std::string name, ValuePtr);
@@ -144,6 +229,9 @@ protected:
 	SharedPtrMap<class Rule> rules_;
 	SharedPtrMap<class Value> variables_;
 	SharedPtrMap<class Value> targets_;
+	size_t effects_;
+	size_t externalEffects_;
+	DefinitionLog *definitionLog_;
 
 };
 
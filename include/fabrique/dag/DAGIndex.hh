@@ -0,0 +1,119 @@
+//! @file DAGIndex.hh    Declaration of @ref fabrique::dag::DAGIndex
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DAG_INDEX_H
+#define DAG_INDEX_H
+
+#include <fabrique/dag/Adjacency.hh>
+#include <fabrique/dag/PathTable.hh>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace fabrique {
+namespace dag {
+
+class Build;
+class DAG;
+class File;
+
+
+/**
+ * Dense indices of the relationships between the nodes of a @ref DAG.
+ *
+ * Files and builds are numbered by their positions in @ref DAG::files and
+ * @ref DAG::builds; rules and targets are numbered in name order. Each
+ * relationship is stored as an @ref Adjacency array, so looking up a node's
+ * neighbours is cheap and walking the whole graph is linear in its size.
+ */
+class DAGIndex
+{
+public:
+	//! Identifies a file, build, rule or target.
+	using ID = Adjacency::ID;
+	using Range = Adjacency::Range;
+
+	//! An ID that doesn't refer to anything.
+	static const ID None = Adjacency::None;
+
+	DAGIndex(const DAG&);
+
+	size_t fileCount() const { return fileIDs_.size(); }
+	size_t buildCount() const { return buildIDs_.size(); }
+	size_t ruleCount() const { return ruleIDs_.size(); }
+	size_t targetCount() const { return targetIDs_.size(); }
+
+	//! The total number of edges in all of the adjacency arrays.
+	size_t edgeCount() const;
+
+	//! Look up a node, returning @ref None if it isn't in the DAG.
+	ID file(const File&) const;
+	ID build(const Build&) const;
+	ID rule(const std::string &name) const;
+	ID target(const std::string &name) const;
+
+	//! The build that produces a file (or @ref None for source files).
+	ID producer(ID file) const;
+
+	//! All builds that produce a file (more than one is an error).
+	Range producers(ID file) const { return producers_[file]; }
+
+	//! Builds that take a file as input.
+	Range consumers(ID file) const { return consumers_[file]; }
+
+	Range inputs(ID build) const { return inputs_[build]; }
+	Range outputs(ID build) const { return outputs_[build]; }
+
+	//! Builds that apply a rule.
+	Range ruleBuilds(ID rule) const { return ruleBuilds_[rule]; }
+
+	//! Files that a named target refers to (e.g., the outputs of a build).
+	Range targetFiles(ID target) const { return targetFiles_[target]; }
+
+private:
+	std::unordered_map<PathTable::ID, ID> fileIDs_;
+	std::unordered_map<const Build*, ID> buildIDs_;
+	std::unordered_map<std::string, ID> ruleIDs_;
+	std::unordered_map<std::string, ID> targetIDs_;
+
+	Adjacency inputs_;
+	Adjacency outputs_;
+	Adjacency consumers_;
+	Adjacency producers_;
+	Adjacency ruleBuilds_;
+	Adjacency targetFiles_;
+};
+
+} // namespace dag
+} // namespace fabrique
+
+#endif
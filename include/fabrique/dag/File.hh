@@ -33,6 +33,8 @@
 #ifndef DAG_FILE_H
 #define DAG_FILE_H
 
+#include <fabrique/dag/Owner.hh>
+#include <fabrique/dag/PathTable.hh>
 #include <fabrique/dag/Value.hh>
 #include <fabrique/types/FileType.hh>
 
@@ -55,6 +57,7 @@ public:
 	                    const FileType&, ValueMap attributes = {},
 	                    SourceRange = SourceRange::None(), bool generated = false);
 
+	//! Do two files have the same full name? (an integer comparison)
 	static bool Equals(const std::shared_ptr<File>&, const std::shared_ptr<File>&);
 	static bool LessThan(const std::shared_ptr<File>&, const std::shared_ptr<File>&);
 
@@ -62,16 +65,26 @@ public:
 
 	virtual ~File() override {}
 
-	virtual std::string filename() const;
-	virtual std::string relativeName() const;
-	virtual std::string fullName() const;
+	virtual const std::string& filename() const;
+	virtual const std::string& relativeName() const;
+	virtual const std::string& fullName() const;
+
+	//! The @ref PathTable ID of this file's full name.
+	PathTable::ID pathID() const { return fullID_; }
 
 	bool generated() const { return generated_; }
+
+	/**
+	 * Mark this file as generated (or not).
+	 *
+	 * Only the @ref Owner that created a file may change this, since it
+	 * changes the file's name as seen by everything that refers to it.
+	 */
 	void setGenerated(bool);
 
 	//! Absolute path to the directory this file is in.
 	std::string directory(bool relativeBuildDirectories = true) const;
-	std::string subdirectory() const { return subdirectory_; }
+	const std::string& subdirectory() const { return subdirectory_; }
 
 	virtual bool hasFields() const override { return true; }
 	virtual ValuePtr field(const std::string& name) const override;
@@ -93,10 +106,19 @@ private:
 	     const ValueMap& attributes, const FileType&, SourceRange,
 	     bool generated);
 
-	const std::string filename_;
-	const std::string subdirectory_;
+	//! (Re-)compute our full name, which depends on whether we're generated.
+	void InternFullName();
+
+	// These strings are all owned by the @ref PathTable.
+	const std::string& filename_;
+	const std::string& subdirectory_;
+	const std::string& relativeName_;
+	const std::string *fullName_;
+	PathTable::ID fullID_;
+
 	const bool absolute_;
 	bool generated_;
+	const Owner::ID owner_;
 	ValueMap attributes_;
 };
 
@@ -0,0 +1,110 @@
+//! @file FileGraph.hh    Declaration of @ref fabrique::dag::FileGraph
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DAG_FILE_GRAPH_H
+#define DAG_FILE_GRAPH_H
+
+#include <fabrique/dag/Adjacency.hh>
+
+#include <string>
+#include <vector>
+
+
+namespace fabrique {
+namespace dag {
+
+class DAG;
+
+
+/**
+ * The dependencies between the files in a @ref DAG, reduced to integers.
+ *
+ * A file depends on the inputs of the build(s) that produce it. Unlike a
+ * DAG, a FileGraph can be serialized and loaded again without evaluating
+ * anything, so queries can be answered from a previous generation's cache.
+ *
+ * Files are named as the Ninja backend names them (relative names for
+ * generated files, full names for sources) and numbered in name order.
+ */
+class FileGraph
+{
+public:
+	using ID = Adjacency::ID;
+	static const ID None = Adjacency::None;
+
+	FileGraph(const DAG&);
+
+	/**
+	 * Load a graph that was saved by @ref Serialize.
+	 *
+	 * @throws UserError if the serialized graph is malformed
+	 */
+	static FileGraph Parse(const std::string&);
+
+	std::string Serialize() const;
+
+	size_t size() const { return names_.size(); }
+	const std::string& name(ID id) const { return names_[id]; }
+
+	/**
+	 * Find a file by name (or, for a source file, by its name relative
+	 * to the source root).
+	 *
+	 * @returns the file's ID or @ref None
+	 */
+	ID find(const std::string &name) const;
+
+	//! Every file that a file (transitively) depends on.
+	std::vector<ID> deps(ID) const;
+
+	//! Every file that (transitively) depends on a file.
+	std::vector<ID> rdeps(ID) const;
+
+	//! One dependency path from one file to another (empty if none exists).
+	std::vector<ID> somepath(ID from, ID to) const;
+
+	//! Every file on any dependency path from one file to another.
+	std::vector<ID> allpaths(ID from, ID to) const;
+
+private:
+	FileGraph(std::vector<std::string> names, const Adjacency::Edges&);
+
+	//! Which nodes can be reached from a node (not including itself)?
+	static std::vector<bool> Reachable(const Adjacency&, ID);
+
+	const std::vector<std::string> names_;
+	const Adjacency dependencies_;
+	const Adjacency dependents_;
+};
+
+} // namespace dag
+} // namespace fabrique
+
+#endif
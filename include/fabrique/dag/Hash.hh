@@ -0,0 +1,62 @@
+//! @file dag/Hash.hh    Structural hashing of @ref fabrique::dag::Value objects
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_DAG_HASH_H_
+#define FAB_DAG_HASH_H_
+
+#include <fabrique/dag/Value.hh>
+
+#include <cstdint>
+
+namespace fabrique {
+namespace dag {
+
+/**
+ * Hash a value according to its structure rather than its identity.
+ *
+ * Primitives, files, lists, records and type references that have the same
+ * type and contents hash to the same value, regardless of where they were
+ * created. Builds, functions and rules are hashed by identity.
+ */
+uint64_t Hash(const Value&);
+
+//! Hash a set of named values (e.g., function arguments) by structure.
+uint64_t Hash(const ValueMap&);
+
+//! Are two values structurally equivalent (see @ref Hash)?
+bool Equivalent(const Value&, const Value&);
+
+//! Are two sets of named values structurally equivalent?
+bool Equivalent(const ValueMap&, const ValueMap&);
+
+} // namespace dag
+} // namespace fabrique
+
+#endif // FAB_DAG_HASH_H_
@@ -32,9 +32,12 @@
 #ifndef DAG_LIST_H
 #define DAG_LIST_H
 
+#include <fabrique/dag/Owner.hh>
 #include <fabrique/dag/Value.hh>
 #include <fabrique/types/SequenceType.hh>
 
+#include <deque>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -43,9 +46,47 @@ namespace fabrique {
 namespace dag {
 
 
-//! The result of evaluating an expression.
+/**
+ * An immutable list of values.
+ *
+ * Lists are persistent: a list is a window onto storage that can be shared
+ * with other lists. Concatenating onto the end of a list that is at the end
+ * of its storage (or prefixing a list that is at the beginning of its
+ * storage) extends the storage in place rather than copying it, so building
+ * a list with a chain of `+` or `::` operations takes linear time overall.
+ * Storage that is shared by several lists must only be extended by one
+ * thread at a time, so it is only extended by the @ref Owner that created it.
+ */
 class List : public Value
 {
+	//! Elements shared by lists, indexed by (possibly-negative) position.
+	struct Storage
+	{
+		Storage() : origin(0), owner(Owner::Current()) {}
+
+		//! Elements in order; references to them are never invalidated.
+		std::deque<ValuePtr> values;
+
+		//! The index of position 0 within @ref values.
+		ptrdiff_t origin;
+
+		//! The evaluation that may extend this storage in place.
+		const Owner::ID owner;
+
+		bool extensible() const { return Owner::MayModify(owner); }
+
+		ptrdiff_t begin() const { return -origin; }
+		ptrdiff_t end() const
+		{
+			return static_cast<ptrdiff_t>(values.size()) - origin;
+		}
+
+		const ValuePtr& operator [] (ptrdiff_t i) const
+		{
+			return values[static_cast<size_t>(i + origin)];
+		}
+	};
+
 public:
 	template<class T>
 	static List* of(const SharedPtrVec<T>& values, const SourceRange& src,
@@ -61,11 +102,33 @@ public:
 	static List* of(const SharedPtrVec<Value>&, const SourceRange&,
 	                TypeContext& ctx);
 
-	typedef SharedPtrVec<Value>::const_iterator iterator;
+	//! Iterates over a list's elements (which remain valid as lists grow).
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ValuePtr;
+		using difference_type = ptrdiff_t;
+		using pointer = const ValuePtr*;
+		using reference = const ValuePtr&;
+
+		iterator(const Storage &s, ptrdiff_t i) : storage_(&s), i_(i) {}
+
+		reference operator * () const { return (*storage_)[i_]; }
+		pointer operator -> () const { return &(*storage_)[i_]; }
+		iterator& operator ++ () { i_++; return *this; }
+		iterator operator ++ (int) { iterator old = *this; i_++; return old; }
+
+		bool operator == (const iterator &other) const { return i_ == other.i_; }
+		bool operator != (const iterator &other) const { return i_ != other.i_; }
+
+	private:
+		const Storage *storage_;
+		ptrdiff_t i_;
+	};
 
 	iterator begin() const;
 	iterator end() const;
-	const SharedPtrVec<Value>& elements() const { return elements_; }
 	size_t size() const;
 	const Value& operator [] (size_t) const;
 
@@ -79,9 +142,15 @@ public:
 	void Accept(Visitor& v) const override;
 
 private:
-	List(const SharedPtrVec<Value>&, const Type&, const SourceRange&);
+	List(std::shared_ptr<Storage>, ptrdiff_t begin, ptrdiff_t end,
+	     const Type&, const SourceRange&);
+
+	//! The type of our elements (only meaningful if we are non-empty).
+	const Type& elementType() const { return type()[0]; }
 
-	const SharedPtrVec<Value> elements_;
+	const std::shared_ptr<Storage> storage_;
+	const ptrdiff_t begin_;
+	const ptrdiff_t end_;
 };
 
 } // namespace dag
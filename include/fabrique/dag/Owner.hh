@@ -0,0 +1,79 @@
+//! @file Owner.hh    Declaration of @ref fabrique::dag::Owner
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DAG_OWNER_H
+#define DAG_OWNER_H
+
+#include <cstdint>
+
+namespace fabrique {
+namespace dag {
+
+/**
+ * An evaluation that owns the values it creates.
+ *
+ * Most values are immutable, but some have state that can be modified in
+ * place (e.g., a list's storage can be extended or a file can become a build
+ * output). Evaluation on worker threads (e.g., the bodies of a parallel
+ * `foreach` or a speculative import) happens on behalf of its own Owner,
+ * and may only modify the values that it has created. Code that is not
+ * evaluated on behalf of any Owner (i.e., the main evaluation thread)
+ * may modify any value, as worker threads never modify its values.
+ */
+class Owner
+{
+public:
+	//! Identifies an Owner; zero means "no owner".
+	using ID = uint64_t;
+
+	//! The Owner that this thread is currently evaluating for (if any).
+	static ID Current();
+
+	//! May this thread modify a value created on behalf of @a owner?
+	static bool MayModify(ID owner);
+
+	//! Evaluate on behalf of a new Owner until this object is destroyed.
+	Owner();
+	~Owner();
+
+	ID id() const { return id_; }
+
+private:
+	Owner(const Owner&) = delete;
+	Owner& operator= (const Owner&) = delete;
+
+	const ID id_;
+	const ID previous_;
+};
+
+} // namespace dag
+} // namespace fabrique
+
+#endif
@@ -0,0 +1,68 @@
+//! @file PathTable.hh    Declaration of @ref fabrique::dag::PathTable
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef DAG_PATH_TABLE_H
+#define DAG_PATH_TABLE_H
+
+#include <cstdint>
+#include <string>
+
+namespace fabrique {
+namespace dag {
+
+/**
+ * The table of paths that @ref File objects refer to.
+ *
+ * Large builds refer to the same directories and files over and over, and
+ * the DAG needs to sort and compare all of those references. Interning each
+ * path in this (process-wide, thread-safe) table means that files can be
+ * compared by ID and that each path string is only built and stored once.
+ */
+class PathTable
+{
+public:
+	//! Identifies a path; zero means the empty path.
+	using ID = uint32_t;
+
+	//! Find the ID of a path, adding the path to the table if necessary.
+	static ID Intern(const std::string &path);
+
+	/**
+	 * Look up a path by ID.
+	 *
+	 * The returned reference remains valid for the life of the process.
+	 */
+	static const std::string& Name(ID);
+};
+
+} // namespace dag
+} // namespace fabrique
+
+#endif
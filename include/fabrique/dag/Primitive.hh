@@ -36,7 +36,10 @@
 #include <fabrique/HasSource.hh>
 #include <fabrique/dag/Value.hh>
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace fabrique {
@@ -112,12 +115,23 @@ private:
 };
 
 
-//! An ASCII string (for now, we should make this Unicode soon).
-class String : public Primitive<std::string>
+/**
+ * An ASCII string (for now, we should make this Unicode soon).
+ *
+ * Concatenating long strings doesn't copy them: the result refers to its
+ * operands (like a rope) and is only flattened into contiguous characters
+ * when its value is needed, so building a long string (e.g., a command line)
+ * with a chain of `+` operations takes linear time.
+ */
+class String : public Value, public std::enable_shared_from_this<String>
 {
 public:
 	String(std::string, const Type&, SourceRange src = SourceRange::None());
-	std::string str() const override;
+
+	//! The string's characters (flattened on first use).
+	const std::string& value() const;
+	std::string str() const override { return value(); }
+	size_t length() const { return length_; }
 
 	virtual ValuePtr Add(ValuePtr&, SourceRange) const override;
 	virtual ValuePtr PrefixWith(ValuePtr&, SourceRange) const override;
@@ -126,6 +140,27 @@ public:
 	virtual void PrettyPrint(Bytestream&, unsigned int indent = 0) const override;
 
 	void Accept(Visitor& v) const override;
+
+private:
+	using Ptr = std::shared_ptr<const String>;
+
+	//! A string formed by concatenating two other strings.
+	String(Ptr left, Ptr right, const Type&, SourceRange);
+
+	//! Concatenate two strings, copying them only if they're short.
+	static ValuePtr Concatenate(Ptr left, Ptr right, const Type&, SourceRange);
+
+	//! Append our characters to a string without flattening ourselves.
+	void AppendTo(std::string&) const;
+
+	const size_t length_;
+
+	//! The operands of a concatenation (null for literal strings).
+	const Ptr left_, right_;
+
+	mutable std::string value_;
+	mutable std::atomic<bool> flat_;
+	mutable std::once_flag flattening_;
 };
 
 } // namespace dag
@@ -36,10 +36,13 @@
 #include <fabrique/dag/Value.hh>
 
 #include <memory>
+#include <vector>
 
 
 namespace fabrique {
 
+class RecordShape;
+class RecordType;
 class TypeContext;
 
 namespace dag {
@@ -56,8 +59,14 @@ public:
 	virtual ~Record() override;
 
 	virtual bool hasFields() const override { return true; }
-	ValueMap fields() const { return fields_; }
+	ValueMap fields() const;
 	virtual ValuePtr field(const std::string& name) const override;
+
+	//! The layout of this record, shared by all records with the same fields.
+	const RecordShape& shape() const { return shape_; }
+
+	//! The value of the field at an offset within this record's @ref shape.
+	const ValuePtr& fieldAt(size_t offset) const { return values_[offset]; }
 	ValuePtr operator[] (const std::string& name) const
 	{
 		return field(name);
@@ -67,9 +76,12 @@ public:
 	void Accept(Visitor&) const override;
 
 private:
-	Record(const ValueMap&, const Type&, SourceRange);
+	Record(const std::vector<ValuePtr>&, const RecordType&, SourceRange);
+
+	const RecordShape &shape_;
 
-	const ValueMap fields_;
+	//! Field values, in @ref shape order.
+	const std::vector<ValuePtr> values_;
 };
 
 } // namespace dag
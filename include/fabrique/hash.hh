@@ -0,0 +1,66 @@
+//! @file  hash.hh    Stable (cross-run) hashing of strings and files
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_HASH_H_
+#define FAB_HASH_H_
+
+#include <cstdint>
+#include <string>
+
+namespace fabrique {
+
+/**
+ * Hash a sequence of bytes.
+ *
+ * Unlike std::hash, this hash function (64-bit FNV-1a) is stable across runs,
+ * builds and platforms, so its values can be written to disk and compared later.
+ *
+ * @param   bytes      the data to hash
+ * @param   previous   a hash value to continue from (e.g., when hashing several
+ *                     strings as a single sequence)
+ */
+uint64_t HashBytes(const std::string &bytes, uint64_t previous = 0xcbf29ce484222325);
+
+//! Combine two hash values into one (e.g., when hashing a structure's fields).
+uint64_t HashCombine(uint64_t, uint64_t);
+
+/**
+ * Hash the contents of a file.
+ *
+ * A file that cannot be read hashes to a value unlike that of any empty file.
+ */
+uint64_t HashFile(const std::string &filename);
+
+//! Render a hash value as a fixed-width hexadecimal string.
+std::string HashString(uint64_t);
+
+} // namespace fabrique
+
+#endif  // FAB_HASH_H_
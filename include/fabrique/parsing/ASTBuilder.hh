@@ -34,6 +34,7 @@
 #define FAB_PARSING_PARSE_TREE_VISITOR_H_
 
 #include <fabrique/AssertionFailure.hh>
+#include <fabrique/SourceFiles.hh>
 #include <fabrique/ast/ast.hh>
 #include <fabrique/parsing/ParserError.hh>
 #include <fabrique/platform/ABI.hh>
@@ -224,7 +225,7 @@ private:
 	Bytestream& debug_;
 	Bytestream& fullDebug_;
 
-	const std::string filename_;
+	const SourceFiles::ID file_;
 	std::stack<std::unique_ptr<ast::Node>> nodes_;
 };
 
@@ -41,6 +41,9 @@
 #include <unordered_map>
 
 namespace fabrique {
+
+class TypeContext;
+
 namespace parsing {
 
 
@@ -53,10 +56,11 @@ public:
 	/**
 	 * Constructor.
 	 *
+	 * @param    types            types to check parsed files against
 	 * @param    prettyPrint      pretty-print values or files as they are parsed
 	 * @param    dump             dump values as they are parsed
 	 */
-	Parser(bool prettyPrint, bool dump);
+	Parser(TypeContext &types, bool prettyPrint, bool dump);
 
 	template<typename T>
 	class Result
@@ -109,7 +113,21 @@ public:
 	//! Retrive a previously-parsed tree.
 	const UniqPtrVec<ast::Value>& parseTree(const std::string &name);
 
+	//! Have we already parsed the named input?
+	bool hasParseTree(const std::string &name) const;
+
+	/**
+	 * Take ownership of the trees parsed by another parser (e.g., one used
+	 * on another thread), as if they had been parsed here.
+	 *
+	 * Inputs that we have already parsed keep their original trees, but
+	 * the other parser's copies are kept alive: values evaluated from them
+	 * may still refer to them.
+	 */
+	void Adopt(Parser&&);
+
 private:
+	TypeContext &types_;
 	const bool prettyPrint_;
 	const bool dump_;
 
@@ -123,6 +141,9 @@ private:
 	 * recall the contents of named files later.
 	 */
 	std::unordered_map<std::string, UniqPtrVec<ast::Value>> parseTrees_;
+
+	//! Duplicate trees taken from other parsers by @ref Adopt.
+	std::vector<UniqPtrVec<ast::Value>> retained_;
 };
 
 } // namespace parsing
@@ -33,6 +33,7 @@
 #define STRINGREF_H
 
 #include <fabrique/HasSource.hh>
+#include <fabrique/Printable.hh>
 
 #include <string>
 
@@ -131,6 +131,24 @@ std::string LibraryFilename(std::string name);
  */
 std::vector<std::string> PluginSearchPaths(std::string executablePath);
 
+
+//
+// File contents:
+//
+
+/**
+ * Replace the contents of a file, but only if they have changed.
+ *
+ * New contents are written to a uniquely-named temporary file in the same
+ * directory that is then renamed over the original, so readers never observe
+ * a partially-written file and concurrent writers never share a temporary file.
+ * If the existing contents are identical, the file (including its modification
+ * time) is untouched.
+ *
+ * @returns   true if the file was written
+ */
+bool WriteFileIfChanged(const std::string &filename, const std::string &contents);
+
 } // namespace platform
 } // namespace fabrique
 
@@ -60,8 +60,12 @@ class Loader
 	 */
 	std::weak_ptr<Plugin> Load(std::string name);
 
+	//! The filenames of all shared libraries that have been loaded.
+	const std::vector<std::string>& filenames() const { return filenames_; }
+
 	private:
 	std::vector<std::string> paths_;
+	std::vector<std::string> filenames_;
 	std::vector<std::shared_ptr<platform::SharedLibrary>> libraries_;
 };
 
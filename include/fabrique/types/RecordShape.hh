@@ -0,0 +1,77 @@
+//! @file types/RecordShape.hh    Declaration of @ref fabrique::RecordShape
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef FAB_RECORD_SHAPE_H_
+#define FAB_RECORD_SHAPE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fabrique {
+
+/**
+ * The layout of a record: its field names, in order, mapped to offsets.
+ *
+ * Shapes are interned by @ref TypeContext, so all record types with the same
+ * field names (whatever the fields' types) share a shape, and a field can be
+ * found at the same offset in every record with that shape.
+ */
+class RecordShape
+{
+public:
+	//! An offset that doesn't refer to any field.
+	static const size_t NoField;
+
+	//! A small, dense integer that uniquely identifies this shape.
+	using ID = uint32_t;
+	ID id() const { return id_; }
+
+	size_t size() const { return names_.size(); }
+	const std::vector<std::string>& names() const { return names_; }
+	const std::string& name(size_t offset) const { return names_[offset]; }
+
+	//! Find the offset of a named field (or @ref NoField).
+	size_t offset(const std::string& name) const;
+
+private:
+	RecordShape(ID, const std::vector<std::string>& names);
+
+	const ID id_;
+	const std::vector<std::string> names_;
+	std::unordered_map<std::string, size_t> offsets_;
+
+	friend class TypeContext;
+};
+
+} // namespace fabrique
+
+#endif // FAB_RECORD_SHAPE_H_
@@ -32,9 +32,9 @@
 #ifndef FAB_RECORD_TYPE_H_
 #define FAB_RECORD_TYPE_H_
 
-#include <fabrique/StringMap.hh>
+#include <fabrique/PtrVec.hh>
+#include <fabrique/types/RecordShape.hh>
 #include <fabrique/types/Type.hh>
-#include <vector>
 
 
 namespace fabrique {
@@ -48,7 +48,13 @@ public:
 	static RecordType* Create(const NamedTypeVec&, TypeContext&);
 
 	virtual ~RecordType() override;
-	TypeMap fields() const override { return fieldTypes_; }
+	TypeMap fields() const override;
+
+	//! The layout of records of this type (shared with similar types).
+	const RecordShape& shape() const { return shape_; }
+
+	//! The type of the field at an offset within this type's @ref shape.
+	const Type& fieldType(size_t offset) const { return *fieldTypes_[offset]; }
 
 	virtual bool hasFields() const override { return true; }
 	virtual bool hasFiles() const override;
@@ -59,19 +65,18 @@ public:
 	virtual void PrettyPrint(Bytestream&, unsigned int indent) const override;
 
 private:
-	RecordType(const StringMap<const Type&>& fields,
-	           const std::vector<std::string>& fieldNames, TypeContext&);
-
-	//! The types of fields within the record.
-	StringMap<const Type&> fieldTypes_;
+	RecordType(const RecordShape&, const PtrVec<Type>& fieldTypes, TypeContext&);
 
 	/**
-	 * Ordered sequence of field names.
+	 * Field names, in order, mapped to offsets.
 	 *
-	 * This isn't semantically relevant, but it's nice to output field names
-	 * in the same order as their definition.
+	 * The order isn't semantically relevant, but it's nice to output field
+	 * names in the same order as their definition.
 	 */
-	std::vector<std::string> fieldNames_;
+	const RecordShape& shape_;
+
+	//! The types of fields within the record, in @ref shape order.
+	const PtrVec<Type> fieldTypes_;
 
 	friend class TypeContext;
 };
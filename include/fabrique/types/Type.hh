@@ -37,6 +37,7 @@
 #include <fabrique/StringMap.hh>
 #include <fabrique/Uncopyable.hh>
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -64,6 +65,10 @@ public:
 
 	TypeContext& context() const { return parent_; }
 
+	//! A small, dense integer that uniquely identifies this type object.
+	using ID = uint32_t;
+	ID id() const { return id_; }
+
 	virtual const std::string name() const;
 
 	typedef StringMap<const Type&> TypeMap;
@@ -89,7 +94,15 @@ public:
 	typedef std::function<PtrVec<Type> (const PtrVec<Type>&)> TypesMapper;
 	const Type& Map(TypesMapper) const;
 
-	virtual bool isSubtype(const Type&) const;
+	/**
+	 * Is this type a subtype of @b t?
+	 *
+	 * This is the uncached, structural check that subclasses override.
+	 * @ref isSupertype and @ref CheckSubtype go through the
+	 * @ref TypeContext's memo table, so recursive checks within
+	 * structural types should use those instead.
+	 */
+	virtual bool isSubtype(const Type& t) const;
 	virtual bool isSupertype(const Type&) const;
 
 	/**
@@ -140,6 +153,7 @@ private:
 	                    TypeContext&);
 
 	TypeContext& parent_;
+	const ID id_;
 	const std::string typeName_;
 	const PtrVec<Type> parameters_;
 
@@ -38,12 +38,17 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace fabrique {
 
 class FileType;
 class FunctionType;
+class RecordShape;
 class RecordType;
 class Type;
 class UserType;
@@ -51,11 +56,14 @@ class UserType;
 
 /**
  * A context object that holds state for a compilation (e.g., type objects).
+ *
+ * Types can be looked up and registered from several threads at once.
  */
 class TypeContext
 {
 public:
 	TypeContext();
+	~TypeContext();
 
 	//! Find an existing type (nil type if not found).
 	const Type& find(const std::string& name,
@@ -94,12 +102,23 @@ public:
 	//! A record type describes its fields' names and types.
 	const RecordType& recordType(const Type::NamedTypeVec&);
 
+	//! The layout shared by all records with these field names (in order).
+	const RecordShape& recordShape(const std::vector<std::string>& fieldNames);
+
 	//! A string of characters.
 	const Type& stringType();
 
 	//! A type that represents a type.
 	const Type& typeType();
 
+	/**
+	 * Is @b sub a subtype of @b super?
+	 *
+	 * Type objects are immutable, so answers are memoised by type ID:
+	 * repeated checks at hot call sites are a single hash probe.
+	 */
+	bool isSubtype(const Type& sub, const Type& super);
+
 
 	/**
 	 * Find the supertype of a range of elements (or nil).
@@ -122,6 +141,26 @@ private:
 	                              const PtrVec<Type>& params = PtrVec<Type>());
 
 	std::map<TypeName,std::unique_ptr<Type>> types;
+
+	/**
+	 * Record types, keyed by their fields in declaration order.
+	 *
+	 * Field order isn't semantically relevant, but it is used when
+	 * pretty-printing a record type, so reordered records are distinct
+	 * (though equal) type objects.
+	 */
+	typedef std::vector<std::pair<std::string,const Type*>> RecordKey;
+	std::map<RecordKey,std::unique_ptr<RecordType>> records_;
+
+	//! Record shapes, keyed by their field names.
+	std::map<std::vector<std::string>,std::unique_ptr<RecordShape>> shapes_;
+
+	//! Memoised subtype answers, keyed by (subtype ID, supertype ID).
+	std::unordered_map<uint64_t,bool> subtypes_;
+	std::mutex subtypeLock_;
+
+	//! Recursive: parameterising a type may look up other types.
+	std::recursive_mutex lock_;
 };
 
 } // namespace fabrique
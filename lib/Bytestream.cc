@@ -35,6 +35,7 @@
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include <fnmatch.h>   // filename-style pattern matching
@@ -130,13 +131,16 @@ public:
 	Bytestream *out = &Bytestream::Stdout();
 	Bytestream *null = &Bytestream::None();
 	string pattern;
+	string longPattern = ".*";
 
-	bool match(const string& name)
-	{
-		string longPattern = pattern + ".*";
+	//! Channels whose state must be updated when the pattern changes.
+	std::vector<Bytestream::DebugChannel*> channels;
+	std::mutex lock;
 
-		return (fnmatch(pattern.c_str(), name.c_str(), 0) == 0)
-			or (fnmatch(longPattern.c_str(), name.c_str(), 0) == 0);
+	bool match(const char *name)
+	{
+		return (fnmatch(pattern.c_str(), name, 0) == 0)
+			or (fnmatch(longPattern.c_str(), name, 0) == 0);
 	}
 
 	Bytestream& get(const string& name)
@@ -144,7 +148,7 @@ public:
 		assert(out);
 		assert(null);
 
-		return match(name) ? *out : *null;
+		return match(name.c_str()) ? *out : *null;
 	}
 };
 
@@ -187,7 +191,16 @@ Bytestream& Bytestream::Debug(const string& name)
 
 void Bytestream::SetDebugPattern(const string& pattern)
 {
-	debugState().pattern = pattern;
+	DebugState &state = debugState();
+	std::lock_guard<std::mutex> lock(state.lock);
+
+	state.pattern = pattern;
+	state.longPattern = pattern + ".*";
+
+	for (DebugChannel *c : state.channels)
+	{
+		c->enabled_ = state.match(c->name_);
+	}
 }
 
 void Bytestream::SetDebugStream(Bytestream& s)
@@ -195,6 +208,21 @@ void Bytestream::SetDebugStream(Bytestream& s)
 	debugState().out = &s;
 }
 
+Bytestream::DebugChannel::DebugChannel(const char *name)
+	: name_(name)
+{
+	DebugState &state = debugState();
+	std::lock_guard<std::mutex> lock(state.lock);
+
+	enabled_ = state.match(name_);
+	state.channels.push_back(this);
+}
+
+Bytestream& Bytestream::DebugChannel::stream() const
+{
+	return enabled_ ? *debugState().out : None();
+}
+
 Bytestream& Bytestream::None()
 {
 	static NullStream& stream = *new NullStream;
@@ -41,7 +41,7 @@ static void DefaultErrorHandler(ErrorReport);
 
 
 FabBuilder::FabBuilder()
-	: err_(DefaultErrorHandler)
+	: useCache_(true), validateDAG_(true), jobs_(1), err_(DefaultErrorHandler)
 {
 }
 
@@ -65,8 +65,9 @@ FabBuilder& FabBuilder::outputDirectory(std::string d)
 Fabrique FabBuilder::build()
 {
 	return Fabrique(parseOnly_, printASTs_, dumpASTs_, printDAG_, stdout_,
-	                std::move(backends_), outputDir_, std::move(pluginPaths_),
-	                regenCommand_, err_);
+	                useCache_, validateDAG_, jobs_, std::move(backends_),
+	                outputDir_, std::move(pluginPaths_), regenCommand_,
+	                executable_, query_, std::move(onlyTargets_), err_);
 }
 
 
@@ -32,15 +32,24 @@
 
 #include <fabrique/Bytestream.hh>
 #include <fabrique/Fabrique.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/UserError.hh>
+#include <fabrique/WorkerPool.hh>
+#include <fabrique/strings.hh>
+#include <fabrique/ast/Demand.hh>
 #include <fabrique/ast/EvalContext.hh>
+#include <fabrique/ast/Optimizer.hh>
 #include <fabrique/dag/DAGBuilder.hh>
 #include <fabrique/parsing/Parser.hh>
 #include <fabrique/platform/files.hh>
 #include <fabrique/plugin/Loader.hh>
 #include <fabrique/types/TypeContext.hh>
 
+#include <cstdlib>
+#include <exception>
 #include <fstream>
+#include <future>
+#include <sstream>
 
 using namespace fabrique;
 using namespace fabrique::platform;
@@ -53,13 +62,21 @@ static void DefineSourcelessBuiltins(ast::EvalContext::Scope&, dag::DAGBuilder&)
 
 
 Fabrique::Fabrique(bool parseOnly, bool printASTs, bool dumpASTs, bool printDAG,
-                   bool printToStdout, UniqPtrVec<backend::Backend> backends,
+                   bool printToStdout, bool useCache, bool validateDAG,
+                   unsigned int jobs, UniqPtrVec<backend::Backend> backends,
                    string outputDir, vector<string> pluginPaths, string regenCommand,
+                   string executable, string query, vector<string> onlyTargets,
                    ErrorReporter err)
-	: parseOnly_(parseOnly), printDAG_(printDAG), printToStdout_(printToStdout),
-	  backends_(std::move(backends)), err_(err), parser_(printASTs, dumpASTs),
+	: parseOnly_(parseOnly), printASTs_(printASTs), dumpASTs_(dumpASTs),
+	  printDAG_(printDAG), printToStdout_(printToStdout),
+	  useCache_(useCache), validateDAG_(validateDAG),
+	  // Pretty-printing ASTs as they are parsed requires a serial order:
+	  jobs_(printASTs or dumpASTs ? 1 : jobs),
+	  backends_(std::move(backends)), err_(err),
+	  parser_(types_, printASTs, dumpASTs), diagnosticsReported_(false),
 	  outputDirectory_(outputDir), pluginPaths_(pluginPaths),
-	  regenerationCommand_(regenCommand)
+	  regenerationCommand_(regenCommand), executable_(executable), query_(query),
+	  onlyTargets_(onlyTargets)
 {
 	for (auto &b : backends_)
 	{
@@ -106,6 +123,7 @@ void Fabrique::AddArguments(const vector<string> &args)
 	for (const string &a : args)
 	{
 		AddArgument(a, ctx);
+		definitions_.push_back(a);
 	}
 }
 
@@ -148,6 +166,34 @@ void Fabrique::Process(const std::string &filename)
 		throw UserError("no such file: '" + fabfile + "'");
 	}
 
+	//
+	// If nothing has changed since our outputs were last generated,
+	// we don't need to parse or evaluate anything.
+	//
+	const bool cacheable = useCache_ and not parseOnly_ and not printASTs_
+		and not dumpASTs_ and not printDAG_ and not printToStdout_
+		and not outputFiles_.empty();
+
+	GenerationCache cache(JoinPath(outputDirectory_, GenerationCache::Filename),
+	                      CacheConfiguration(abspath));
+
+	if (not query_.empty())
+	{
+		// Queries can be answered from the file graph of a previous
+		// generation (with the same configuration and unchanged inputs).
+		if (useCache_ and not parseOnly_ and not printDAG_ and cache.Load()
+		    and not cache.fileGraph().empty())
+		{
+			Query(dag::FileGraph::Parse(cache.fileGraph()));
+			return;
+		}
+	}
+	else if (cacheable and cache.Load())
+	{
+		WriteOutputs(cache.outputs());
+		return;
+	}
+
 	//
 	// Open and parse the file.
 	//
@@ -164,12 +210,34 @@ void Fabrique::Process(const std::string &filename)
 		return;
 	}
 
+	// Arguments defined on the command line are known before evaluation,
+	// so conditions on them can be decided ahead of time.
+	if (not arguments_.empty())
+	{
+		Trace::Span span("optimize", "arguments");
+
+		ast::Optimizer()
+			.Add(UniqPtr<ast::OptimizationPass>(
+				new ast::ArgumentPropagation(arguments_)))
+			.AddStandardPasses(types_)
+			.Optimize(values);
+	}
+
 
 	//
 	// Convert the AST into a build graph.
 	//
 	plugin::Loader pluginLoader(pluginPaths_);
-	ast::EvalContext ctx(types_);
+
+	// Independent imports and foreach bodies can be evaluated on worker threads.
+	// The pool must outlive any evaluation that might use it.
+	unique_ptr<WorkerPool> workers;
+	if (jobs_ != 1)
+	{
+		workers.reset(new WorkerPool(jobs_));
+	}
+
+	ast::EvalContext ctx(types_, workers.get());
 	dag::DAGBuilder &builder = ctx.builder();
 
 	auto scope = ctx.EnterScope(fabfile);
@@ -182,14 +250,28 @@ void Fabrique::Process(const std::string &filename)
 	scope.DefineReserved("srcroot", builder.File(srcroot));
 	scope.DefineReserved("buildroot", builder.File(outputDirectory_));
 	scope.DefineReserved("import",
-		builtins::Import(parser_, pluginLoader, srcroot, ctx));
+		builtins::Import(parser_, pluginLoader, srcroot, ctx, workers.get()));
 
 	// Also define srcroot as an explicit variable in the DAG:
 	builder.Define("srcroot", builder.String(srcroot));
 
+	// When generating only some targets, skip the values they don't need.
+	// Values are still evaluated in source order so that the DAG comes
+	// out exactly as it would from a full evaluation.
+	vector<bool> demanded(values.size(), true);
+	if (not onlyTargets_.empty())
+	{
+		Trace::Span span("eval", "demand");
+		demanded = ast::Demand().Demanded(values, onlyTargets_);
+	}
+
 	vector<string> targets;
-	for (const auto& v : values)
+	for (size_t i = 0; i < values.size(); i++)
 	{
+		if (not demanded[i])
+			continue;
+
+		const auto& v = values[i];
 		ctx.Define(*v);
 		if (auto &name = v->name())
 		{
@@ -204,7 +286,7 @@ void Fabrique::Process(const std::string &filename)
 			regenerationCommand_, parser_.inputs(), outputFiles_);
 	}
 
-	unique_ptr<dag::DAG> dag = builder.dag(targets);
+	unique_ptr<dag::DAG> dag = builder.dag(targets, validateDAG_, onlyTargets_);
 	FAB_ASSERT(dag, "null DAG");
 
 	if (printDAG_)
@@ -212,47 +294,255 @@ void Fabrique::Process(const std::string &filename)
 		dag->PrettyPrint(Bytestream::Stdout());
 	}
 
+	if (not query_.empty())
+	{
+		Query(dag::FileGraph(*dag));
+		return;
+	}
+
 
 	//
 	// Finally, feed the build graph into the backend(s).
 	//
-	auto err = std::bind(&Fabrique::ReportError, this, _1, _2, _3, _4);
+	if (printToStdout_)
+	{
+		auto err = std::bind(&Fabrique::ReportError, this, _1, _2, _3, _4);
+
+		for (const auto &b : backends_)
+		{
+			Trace::Span span("backend", b->DefaultFilename());
+			b->Process(*dag, Bytestream::Stdout(), err);
+		}
+
+		return;
+	}
+
+	vector<GenerationCache::Output> outputs = Render(*dag);
+	WriteOutputs(outputs);
+
+	// Outputs that required warnings or other output (e.g., from print())
+	// aren't cached: that output should appear every time that the outputs
+	// are generated.
+	if (cacheable and not diagnosticsReported_
+	    and builder.externalEffects() == 0)
+	{
+		vector<string> inputs = parser_.inputs();
+		const vector<string> &plugins = pluginLoader.filenames();
+		inputs.insert(inputs.end(), plugins.begin(), plugins.end());
+
+		// A different fab (e.g., after an upgrade) may generate different
+		// outputs from the same inputs:
+		if (not executable_.empty())
+		{
+			inputs.push_back(executable_);
+		}
+
+		cache.Save(inputs, std::move(outputs), dag::FileGraph(*dag).Serialize());
+	}
+}
+
+
+void Fabrique::ReportError(string message, SourceRange src, ErrorReport::Severity severity,
+                           string detail)
+{
+	diagnosticsReported_ = true;
+	err_(ErrorReport(message, src, severity, detail));
+}
+
+
+vector<GenerationCache::Output> Fabrique::Render(const dag::DAG &dag)
+{
+	//! The output of one backend, along with any errors it reported.
+	struct Rendering
+	{
+		string output;
+		vector<ErrorReport> reports;
+	};
+
+	auto render = [&dag](backend::Backend &b)
+	{
+		Trace::Span span("backend", b.DefaultFilename());
+
+		Rendering r;
+		auto report = [&r](string message, SourceRange src,
+		                   ErrorReport::Severity severity, string detail)
+		{
+			r.reports.emplace_back(message, src, severity, detail);
+		};
+
+		std::ostringstream buffer;
+		unique_ptr<Bytestream> out(Bytestream::Plain(buffer));
+		b.Process(dag, *out, report);
 
+		r.output = buffer.str();
+		return r;
+	};
+
+	// The DAG is immutable, so backends can process it concurrently.
+	// There's no point in starting a thread if there's only one backend, however.
+	const auto policy =
+		backends_.size() > 1 ? std::launch::async : std::launch::deferred;
+
+	vector<std::future<Rendering>> renderings;
 	for (const auto &b : backends_)
 	{
-		std::ofstream outfile;
-		unique_ptr<Bytestream> outfileStream;
-		Bytestream *out;
+		renderings.push_back(std::async(policy, render, std::ref(*b)));
+	}
 
+	// Collect outputs and report errors in backend order (not completion order)
+	// to keep our output deterministic. Waiting on every future before
+	// re-throwing any backend's exception ensures that no thread outlives us.
+	vector<GenerationCache::Output> outputs;
+	std::exception_ptr failure;
 
-		if (printToStdout_)
+	for (size_t i = 0; i < backends_.size(); i++)
+	{
+		Rendering r;
+		try
 		{
-			out = &Bytestream::Stdout();
+			r = renderings[i].get();
 		}
-		else
+		catch (...)
 		{
-			const string outputFilename =
-				JoinPath(outputDirectory_, b->DefaultFilename());
+			if (not failure)
+			{
+				failure = std::current_exception();
+			}
+			continue;
+		}
 
-			outfile.open(outputFilename);
-			outputFiles_.push_back(outputFilename);
+		for (const ErrorReport &report : r.reports)
+		{
+			diagnosticsReported_ = true;
+			err_(report);
+		}
 
-			outfileStream.reset(Bytestream::Plain(outfile));
-			out = outfileStream.get();
+		const string filename = backends_[i]->DefaultFilename();
+		if (not filename.empty())
+		{
+			outputs.emplace_back(filename, std::move(r.output));
 		}
+	}
+
+	if (failure)
+	{
+		std::rethrow_exception(failure);
+	}
+
+	return outputs;
+}
 
-		b->Process(*dag, *out, err);
 
-		outfile.flush();
-		outfile.close();
+void Fabrique::Query(const dag::FileGraph &graph) const
+{
+	Trace::Span span("query", query_);
+
+	const string usage =
+		"invalid query '" + query_ + "' (expected deps(file), rdeps(file),"
+		" somepath(from, to) or allpaths(from, to))";
+
+	const size_t open = query_.find('(');
+	if (open == string::npos or query_.back() != ')')
+	{
+		throw UserError(usage);
+	}
+
+	const string kind = query_.substr(0, open);
+
+	vector<dag::FileGraph::ID> files;
+	for (string name : Split(query_.substr(open + 1, query_.size() - open - 2)))
+	{
+		const size_t begin = name.find_first_not_of(" \t");
+		const size_t end = name.find_last_not_of(" \t");
+		name = (begin == string::npos) ? "" : name.substr(begin, end - begin + 1);
+
+		const dag::FileGraph::ID id = graph.find(name);
+		if (id == dag::FileGraph::None)
+		{
+			throw UserError("no such file in build graph: '" + name + "'");
+		}
+
+		files.push_back(id);
+	}
+
+	vector<dag::FileGraph::ID> result;
+
+	if (kind == "deps" and files.size() == 1)
+		result = graph.deps(files[0]);
+
+	else if (kind == "rdeps" and files.size() == 1)
+		result = graph.rdeps(files[0]);
+
+	else if (kind == "somepath" and files.size() == 2)
+		result = graph.somepath(files[0], files[1]);
+
+	else if (kind == "allpaths" and files.size() == 2)
+		result = graph.allpaths(files[0], files[1]);
+
+	else
+		throw UserError(usage);
+
+	Bytestream &out = Bytestream::Stdout();
+	for (dag::FileGraph::ID id : result)
+	{
+		out << Bytestream::Filename << graph.name(id) << Bytestream::Reset << "\n";
 	}
 }
 
 
-void Fabrique::ReportError(string message, SourceRange src, ErrorReport::Severity severity,
-                           string detail)
+vector<string> Fabrique::CacheConfiguration(const string &fabfile) const
 {
-	err_(ErrorReport(message, src, severity, detail));
+	vector<string> config = { fabfile, outputDirectory_, regenerationCommand_ };
+	config.insert(config.end(), definitions_.begin(), definitions_.end());
+	config.insert(config.end(), pluginPaths_.begin(), pluginPaths_.end());
+
+	// A sliced build description is different from the full one:
+	if (not onlyTargets_.empty())
+	{
+		config.push_back("--only=" + join(onlyTargets_, ","));
+	}
+
+	// Outputs generated from an unvalidated DAG aren't known to be valid:
+	if (not validateDAG_)
+	{
+		config.push_back("--no-validate");
+	}
+
+	for (const auto &b : backends_)
+	{
+		config.push_back(b->DefaultFilename());
+	}
+
+	// Plugins can search the PATH (e.g., the `which` plugin):
+	if (const char *path = getenv("PATH"))
+	{
+		config.push_back(string("PATH=") + path);
+	}
+
+	return config;
+}
+
+
+void Fabrique::WriteOutputs(const vector<GenerationCache::Output> &outputs)
+{
+	Bytestream &dbg = Bytestream::Debug("output");
+
+	for (const auto &o : outputs)
+	{
+		const string filename = JoinPath(outputDirectory_, o.first);
+
+		// Leave unchanged files alone so that their modification times
+		// don't cause tools like Ninja to reload them:
+		const bool written = WriteFileIfChanged(filename, o.second);
+		outputFiles_.push_back(filename);
+
+		dbg
+			<< Bytestream::Action << (written ? "wrote" : "unchanged")
+			<< Bytestream::Reset << " "
+			<< Bytestream::Filename << filename
+			<< Bytestream::Reset << "\n"
+			;
+	}
 }
 
 
@@ -0,0 +1,206 @@
+//! @file  GenerationCache.cc    Definition of fabrique::GenerationCache
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/Bytestream.hh>
+#include <fabrique/GenerationCache.hh>
+#include <fabrique/hash.hh>
+#include <fabrique/platform/files.hh>
+
+#include <fstream>
+#include <sstream>
+
+using namespace fabrique;
+using std::string;
+using std::vector;
+
+namespace {
+
+//! Identifies the cache file format: bump when changing the format.
+const char FormatHeader[] = "fabrique-generation-cache 2";
+
+}
+
+const char GenerationCache::Filename[] = ".fabrique-cache";
+
+
+GenerationCache::GenerationCache(string filename, vector<string> configuration)
+	: filename_(std::move(filename)), configuration_(std::move(configuration))
+{
+}
+
+
+bool GenerationCache::Load()
+{
+	Bytestream &dbg = Bytestream::Debug("cache");
+	outputs_.clear();
+	fileGraph_.clear();
+
+	std::ifstream f(filename_, std::ios::binary);
+	if (not f.good())
+	{
+		dbg
+			<< Bytestream::Action << "cache miss"
+			<< Bytestream::Reset << ": no cache file "
+			<< Bytestream::Literal << filename_
+			<< Bytestream::Reset << "\n"
+			;
+		return false;
+	}
+
+	string header, key;
+	size_t inputCount;
+	std::getline(f, header);
+	f >> key >> inputCount;
+	f.ignore();
+
+	vector<string> inputs;
+	for (size_t i = 0; f.good() and i < inputCount; i++)
+	{
+		string name;
+		std::getline(f, name);
+		inputs.push_back(name);
+	}
+
+	if (not f.good() or header != FormatHeader or key != HashString(Key(inputs)))
+	{
+		dbg
+			<< Bytestream::Action << "cache miss"
+			<< Bytestream::Reset << ": configuration or inputs have changed\n"
+			;
+		return false;
+	}
+
+	size_t outputCount;
+	f >> outputCount;
+
+	vector<Output> outputs;
+	for (size_t i = 0; f.good() and i < outputCount; i++)
+	{
+		size_t length;
+		string name;
+
+		f >> length;
+		f.ignore();
+		std::getline(f, name);
+
+		string contents(length, '\0');
+		f.read(&contents[0], static_cast<std::streamsize>(length));
+
+		outputs.emplace_back(name, contents);
+	}
+
+	size_t graphLength = 0;
+	f >> graphLength;
+	f.ignore();
+
+	string fileGraph(graphLength, '\0');
+	if (graphLength > 0)
+	{
+		f.read(&fileGraph[0], static_cast<std::streamsize>(graphLength));
+	}
+
+	if (not f.good())
+	{
+		dbg
+			<< Bytestream::Action << "cache miss"
+			<< Bytestream::Reset << ": truncated cache file "
+			<< Bytestream::Literal << filename_
+			<< Bytestream::Reset << "\n"
+			;
+		return false;
+	}
+
+	dbg
+		<< Bytestream::Action << "cache hit"
+		<< Bytestream::Reset << ": "
+		<< static_cast<unsigned long>(inputs.size()) << " inputs unchanged, "
+		<< static_cast<unsigned long>(outputs.size()) << " outputs\n"
+		;
+
+	outputs_ = std::move(outputs);
+	fileGraph_ = std::move(fileGraph);
+	return true;
+}
+
+
+void GenerationCache::Save(const vector<string> &inputs, vector<Output> outputs,
+                           string fileGraph)
+{
+	std::ostringstream f;
+
+	f
+		<< FormatHeader << "\n"
+		<< HashString(Key(inputs)) << " " << inputs.size() << "\n"
+		;
+
+	for (const string &name : inputs)
+	{
+		f << name << "\n";
+	}
+
+	f << outputs.size() << "\n";
+	for (const Output &o : outputs)
+	{
+		f << o.second.length() << " " << o.first << "\n" << o.second;
+	}
+
+	f << fileGraph.length() << "\n" << fileGraph;
+
+	platform::WriteFileIfChanged(filename_, f.str());
+
+	Bytestream::Debug("cache")
+		<< Bytestream::Action << "saved"
+		<< Bytestream::Reset << " "
+		<< static_cast<unsigned long>(outputs.size()) << " outputs to "
+		<< Bytestream::Literal << filename_
+		<< Bytestream::Reset << "\n"
+		;
+
+	outputs_ = std::move(outputs);
+	fileGraph_ = std::move(fileGraph);
+}
+
+
+uint64_t GenerationCache::Key(const vector<string> &inputs) const
+{
+	uint64_t key = HashBytes(FormatHeader);
+
+	for (const string &c : configuration_)
+	{
+		key = HashBytes(c, key);
+	}
+
+	for (const string &filename : inputs)
+	{
+		key = HashCombine(HashBytes(filename, key), HashFile(filename));
+	}
+
+	return key;
+}
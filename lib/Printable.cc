@@ -40,10 +40,33 @@ using namespace fabrique;
 
 std::string Printable::str() const
 {
-	std::ostringstream oss;
-	std::unique_ptr<Bytestream> out(Bytestream::Plain(oss));
+	//
+	// Constructing a stream is surprisingly expensive, so each thread
+	// reuses one (unless we're called while printing something else).
+	//
+	thread_local std::ostringstream buffer;
+	thread_local std::unique_ptr<Bytestream> stream(Bytestream::Plain(buffer));
+	thread_local bool busy = false;
 
-	*out << *this;
+	if (busy)
+	{
+		std::ostringstream oss;
+		std::unique_ptr<Bytestream> out(Bytestream::Plain(oss));
 
-	return oss.str();
+		*out << *this;
+
+		return oss.str();
+	}
+
+	struct Claim
+	{
+		Claim(bool &b) : busy(b) { busy = true; }
+		~Claim() { busy = false; }
+		bool &busy;
+	} claim(busy);
+
+	buffer.str("");
+	*stream << *this;
+
+	return buffer.str();
 }
@@ -38,44 +38,62 @@
 #include <fabrique/Bytestream.hh>
 #include <fabrique/SourceLocation.hh>
 
-#include <cassert>
-#include <fstream>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <type_traits>
 
 using namespace fabrique;
 using std::string;
 
+static_assert(sizeof(SourceLocation) == 8, "SourceLocation should be 8 B");
+static_assert(std::is_trivially_copyable<SourceLocation>::value,
+              "SourceLocation should be trivially copyable");
+
+
+static uint32_t Position(size_t line, size_t column, unsigned int columnBits)
+{
+	const size_t maxLine = (size_t{1} << (32 - columnBits)) - 1;
+	const size_t maxColumn = (size_t{1} << columnBits) - 1;
+
+	return static_cast<uint32_t>(
+		(std::min(line, maxLine) << columnBits) | std::min(column, maxColumn));
+}
+
 
 SourceLocation::SourceLocation(const std::string& file, size_t lineno, size_t colno)
-	: filename(file), line(lineno), column(colno)
+	: SourceLocation(SourceFiles::Intern(file), lineno, colno)
+{
+}
+
+SourceLocation::SourceLocation(SourceFiles::ID file, size_t lineno, size_t colno)
+	: file_(file), position_(Position(lineno, colno, ColumnBits))
+{
+}
+
+const string& SourceLocation::filename() const
 {
+	return SourceFiles::Name(file_);
 }
 
 SourceLocation::operator bool() const
 {
-	return not (line == 0);
+	return not (line() == 0);
 }
 
 bool SourceLocation::operator < (const SourceLocation& other) const
 {
-	return *this or not other
-		or filename < other.filename
-		or line < other.line
-		or (line == other.line and column < other.column);
+	return key() < other.key();
 }
 
 bool SourceLocation::operator > (const SourceLocation& other) const
 {
-	return *this or not other
-		or filename > other.filename
-		or line > other.line
-		or (line == other.line and column > other.column);
+	return key() > other.key();
 }
 
 bool SourceLocation::operator == (const SourceLocation& other) const
 {
-	return filename == other.filename
-		and line == other.line
-		and column == other.column;
+	return key() == other.key();
 }
 
 
@@ -86,22 +104,39 @@ bool SourceLocation::operator != (const SourceLocation& other) const
 
 void SourceLocation::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
 {
+	const string &name = filename();
+
 	out
 		<< Bytestream::Filename
-		<< (filename.empty() ? "-" : filename)
+		<< (name.empty() ? "-" : name)
 		;
 
-	if (line > 0)
+	if (line() > 0)
 		out
 			<< Bytestream::Operator << ":"
-			<< Bytestream::Line << line
+			<< Bytestream::Line << line()
 			;
 
-	if (column > 0)
+	if (column() > 0)
 		out
 			<< Bytestream::Operator << ":"
-			<< Bytestream::Column << column
+			<< Bytestream::Column << column()
 			;
 
 	out << Bytestream::Reset;
 }
+
+string SourceLocation::str() const
+{
+	std::ostringstream oss;
+	std::unique_ptr<Bytestream> out(Bytestream::Plain(oss));
+	PrettyPrint(*out);
+
+	return oss.str();
+}
+
+Bytestream& fabrique::operator << (Bytestream &out, const SourceLocation &loc)
+{
+	loc.PrettyPrint(out);
+	return out;
+}
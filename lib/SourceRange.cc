@@ -35,10 +35,17 @@
 
 #include <cassert>
 #include <fstream>
+#include <memory>
+#include <sstream>
+#include <type_traits>
 
 using namespace fabrique;
 using std::string;
 
+static_assert(sizeof(SourceRange) == 16, "SourceRange should be 16 B");
+static_assert(std::is_trivially_copyable<SourceRange>::value,
+              "SourceRange should be trivially copyable");
+
 
 const SourceRange& SourceRange::None()
 {
@@ -66,9 +73,11 @@ SourceRange::SourceRange(const HasSource& b, const HasSource& e)
 SourceRange SourceRange::Span(const std::string& filename, size_t line,
                               size_t begin, size_t end)
 {
+	const SourceFiles::ID file = SourceFiles::Intern(filename);
+
 	return SourceRange(
-		SourceLocation(filename, line, begin),
-		SourceLocation(filename, line, end)
+		SourceLocation(file, line, begin),
+		SourceLocation(file, line, end)
 	);
 }
 
@@ -80,12 +89,12 @@ SourceRange::operator bool() const
 
 bool SourceRange::operator < (const SourceRange& other) const
 {
-	return begin < other.begin or end < other.end;
+	return begin < other.begin or (begin == other.begin and end < other.end);
 }
 
 bool SourceRange::operator > (const SourceRange& other) const
 {
-	return begin > other.begin or end > other.end;
+	return other < *this;
 }
 
 bool SourceRange::operator == (const SourceRange& other) const
@@ -102,60 +111,37 @@ bool SourceRange::operator != (const SourceRange& other) const
 
 bool SourceRange::isInside(const SourceRange& other) const
 {
-	if (begin.filename != other.begin.filename
-	    or end.filename != other.end.filename)
-	{
-		return false;
-	}
-
-	if (begin.line < other.begin.line)
-	{
-		return false;
-	}
-
-	if (begin.line == other.begin.line and begin.column < other.begin.column)
-	{
-		return false;
-	}
-
-	if (end.line > other.end.line)
-	{
-		return false;
-	}
-
-	if (end.line == other.end.line and end.column > other.end.column)
-	{
-		return false;
-	}
-
-	return true;
+	return begin.file() == other.begin.file()
+		and end.file() == other.end.file()
+		and not (begin < other.begin)
+		and not (end > other.end);
 }
 
-string SourceRange::filename() const
+const string& SourceRange::filename() const
 {
-	return begin.filename;
+	return begin.filename();
 }
 
 void SourceRange::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
 {
 	out
-		<< Bytestream::Filename << begin.filename
+		<< Bytestream::Filename << begin.filename()
 		<< Bytestream::Operator << ":"
 		;
 
 	// The end column is the first character in the next token; don't
 	// report this when printing out the current location.
-	size_t endcol = end.column ? end.column - 1 : 0;
+	size_t endcol = end.column() ? end.column() - 1 : 0;
 
-	if (begin.line == end.line)
+	if (begin.line() == end.line())
 	{
 		out
-			<< Bytestream::Line << begin.line
+			<< Bytestream::Line << begin.line()
 			<< Bytestream::Operator << ":"
-			<< Bytestream::Column << begin.column
+			<< Bytestream::Column << begin.column()
 			;
 
-		if (endcol != begin.column)
+		if (endcol != begin.column())
 			out
 				<< Bytestream::Operator << "-"
 				<< Bytestream::Column << endcol
@@ -163,11 +149,11 @@ void SourceRange::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
 	}
 	else
 		out
-			<< Bytestream::Line << begin.line
+			<< Bytestream::Line << begin.line()
 			<< Bytestream::Operator << ":"
-			<< Bytestream::Column << begin.column
+			<< Bytestream::Column << begin.column()
 			<< Bytestream::Operator << "-"
-			<< Bytestream::Line << end.line
+			<< Bytestream::Line << end.line()
 			<< Bytestream::Operator << ":"
 			<< Bytestream::Column << endcol
 			;
@@ -187,7 +173,7 @@ Bytestream& SourceRange::PrintSource(Bytestream& out, SourceLocation caret,
 	 * code works, so we need to re-open the file. Also, this means that we can't
 	 * do anything similar for stdin.
 	 */
-	const string filename = begin.filename;
+	const string &filename = begin.filename();
 
 	if (!filename.empty())
 	{
@@ -199,16 +185,17 @@ Bytestream& SourceRange::PrintSource(Bytestream& out, SourceLocation caret,
 
 		string line;   // the last-read line
 
-		const size_t firstLine = begin.line > context ? (begin.line - context) : 1;
-		size_t endColumn = end.column;
+		const size_t firstLine =
+			begin.line() > context ? (begin.line() - context) : 1;
+		size_t endColumn = end.column();
 
-		for (size_t i = 1; i <= end.line; i++)
+		for (size_t i = 1; i <= end.line(); i++)
 		{
 			getline(sourceFile, line);
 
 			if (i >= firstLine)
 			{
-				if (i >= begin.line and begin.line != end.line)
+				if (i >= begin.line() and begin.line() != end.line())
 				{
 					endColumn = std::max(endColumn, line.length());
 				}
@@ -227,9 +214,11 @@ Bytestream& SourceRange::PrintSource(Bytestream& out, SourceLocation caret,
 		 *
 		 * Otherwise, start where the source range says to.
 		 */
-		const size_t beginColumn = (begin.line == end.line) ? begin.column : 1;
-		const size_t preCaretHighlight = caret ? (caret.column - beginColumn) : 0;
-		const size_t soFar = caret ? caret.column + 1 : beginColumn;
+		const size_t beginColumn =
+			(begin.line() == end.line()) ? begin.column() : 1;
+		const size_t preCaretHighlight =
+			caret ? (caret.column() - beginColumn) : 0;
+		const size_t soFar = caret ? caret.column() + 1 : beginColumn;
 		const size_t postCaretHighlight =
 			(soFar > endColumn) ? 0 : endColumn - soFar;
 
@@ -254,3 +243,18 @@ Bytestream& SourceRange::PrintSource(Bytestream& out, SourceLocation caret,
 
 	return out;
 }
+
+string SourceRange::str() const
+{
+	std::ostringstream oss;
+	std::unique_ptr<Bytestream> out(Bytestream::Plain(oss));
+	PrettyPrint(*out);
+
+	return oss.str();
+}
+
+Bytestream& fabrique::operator << (Bytestream &out, const SourceRange &src)
+{
+	src.PrettyPrint(out);
+	return out;
+}
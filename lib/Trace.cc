@@ -0,0 +1,178 @@
+//! @file  Trace.cc    Definition of fabrique::Trace
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/Trace.hh>
+#include <fabrique/UserError.hh>
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace fabrique;
+using std::string;
+
+namespace {
+
+struct Event
+{
+	const char *category;
+	string name;
+	Trace::Clock::time_point start;
+	Trace::Clock::time_point end;
+	unsigned long thread;
+};
+
+struct TraceState
+{
+	string filename;
+	Trace::Clock::time_point epoch;
+	std::vector<Event> events;
+	std::map<std::thread::id, unsigned long> threads;
+	std::mutex lock;
+};
+
+TraceState& state()
+{
+	static TraceState& s = *new TraceState;
+	return s;
+}
+
+//! Escape a string for inclusion in a JSON document.
+string JSONString(const string &s)
+{
+	string escaped = "\"";
+
+	for (const char c : s)
+	{
+		switch (c)
+		{
+			case '"':     escaped += "\\\"";    break;
+			case '\\':    escaped += "\\\\";    break;
+			case '\n':    escaped += "\\n";     break;
+			case '\t':    escaped += "\\t";     break;
+
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					const char hex[] = "0123456789abcdef";
+					escaped += "\\u00";
+					escaped += hex[(c >> 4) & 0xf];
+					escaped += hex[c & 0xf];
+				}
+				else
+				{
+					escaped += c;
+				}
+		}
+	}
+
+	return escaped + "\"";
+}
+
+//! Microseconds since the start of tracing.
+long long Microseconds(Trace::Clock::time_point t)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	return duration_cast<microseconds>(t - state().epoch).count();
+}
+
+} // anonymous namespace
+
+
+bool Trace::enabled_ = false;
+
+
+void Trace::Enable(string filename)
+{
+	TraceState &s = state();
+	s.filename = std::move(filename);
+	s.epoch = Clock::now();
+	enabled_ = true;
+}
+
+
+void Trace::Finish()
+{
+	if (not enabled_)
+	{
+		return;
+	}
+
+	enabled_ = false;
+
+	TraceState &s = state();
+	std::lock_guard<std::mutex> lock(s.lock);
+
+	std::ofstream f(s.filename);
+	if (not f.good())
+	{
+		throw UserError("failed to open trace file '" + s.filename + "'");
+	}
+
+	f << "{\"traceEvents\":[";
+
+	for (size_t i = 0; i < s.events.size(); i++)
+	{
+		const Event &e = s.events[i];
+
+		f
+			<< (i == 0 ? "\n" : ",\n")
+			<< "{\"name\":" << JSONString(e.name)
+			<< ",\"cat\":" << JSONString(e.category)
+			<< ",\"ph\":\"X\""
+			<< ",\"ts\":" << Microseconds(e.start)
+			<< ",\"dur\":" << Microseconds(e.end) - Microseconds(e.start)
+			<< ",\"pid\":1,\"tid\":" << e.thread
+			<< "}"
+			;
+	}
+
+	f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	s.events.clear();
+}
+
+
+void Trace::Record(const char *category, const string &name,
+                   Clock::time_point start, Clock::time_point end)
+{
+	TraceState &s = state();
+	std::lock_guard<std::mutex> lock(s.lock);
+
+	// Number threads in order of appearance rather than using opaque IDs:
+	const auto id = std::this_thread::get_id();
+	const unsigned long thread =
+		s.threads.emplace(id, s.threads.size() + 1).first->second;
+
+	s.events.push_back({ category, name, start, end, thread });
+}
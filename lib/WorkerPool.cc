@@ -0,0 +1,100 @@
+//! @file WorkerPool.cc    Definition of @ref fabrique::WorkerPool
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/WorkerPool.hh>
+
+#include <algorithm>
+
+using namespace fabrique;
+
+
+WorkerPool::WorkerPool(unsigned int threads)
+	: stopping_(false)
+{
+	if (threads == 0)
+	{
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned int i = 0; i < threads; i++)
+	{
+		threads_.emplace_back(&WorkerPool::Work, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		stopping_ = true;
+		tasks_.clear();
+	}
+
+	ready_.notify_all();
+
+	for (std::thread &t : threads_)
+	{
+		t.join();
+	}
+}
+
+void WorkerPool::Submit(Task t)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		tasks_.push_back(std::move(t));
+	}
+
+	ready_.notify_one();
+}
+
+void WorkerPool::Work()
+{
+	while (true)
+	{
+		Task t;
+
+		{
+			std::unique_lock<std::mutex> guard(lock_);
+			ready_.wait(guard,
+				[this] { return stopping_ or not tasks_.empty(); });
+
+			if (stopping_)
+			{
+				return;
+			}
+
+			t = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+
+		t();
+	}
+}
@@ -152,18 +152,19 @@ dag::ValuePtr Action::evaluate(EvalContext& ctx) const
 
 	for (const UniqPtr<Argument>& arg : args_->keyword())
 	{
-		std::string str = arg->getValue().evaluate(ctx)->str();
+		dag::ValuePtr value = arg->getValue().evaluate(ctx);
 
 		if (arg->getName().name() == "command")
 		{
 			SemaCheck(command.empty(), arg->source(), "duplicate command");
-			command = str;
+			command = value->str();
 		}
 		else
 		{
-			dag::ValuePtr v(
-				new dag::String(str, types.stringType(), arg->source())
-			);
+			// Strings can be used as-is; other values are stringified.
+			auto s = std::dynamic_pointer_cast<dag::String>(value);
+			dag::ValuePtr v = s ? s : dag::ValuePtr(new dag::String(
+				value->str(), types.stringType(), arg->source()));
 			arguments.emplace(arg->getName().name(), v);
 		}
 	}
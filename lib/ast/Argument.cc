@@ -72,6 +72,11 @@ void Argument::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Argument::RewriteSubexpressions(const Rewriter& r)
+{
+	r(value_);
+}
+
 dag::ValuePtr Argument::evaluate(EvalContext& ctx) const
 {
 	return value_->evaluate(ctx);
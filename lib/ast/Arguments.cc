@@ -80,3 +80,16 @@ void Arguments::Accept(Visitor &v) const
 
 	v.Leave(*this);
 }
+
+void Arguments::RewriteSubexpressions(const Rewriter& r)
+{
+	for (auto &p : positional_)
+	{
+		r(p);
+	}
+
+	for (auto &kwarg : keyword_)
+	{
+		kwarg->RewriteSubexpressions(r);
+	}
+}
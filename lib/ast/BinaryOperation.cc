@@ -34,7 +34,9 @@
 #include <fabrique/Bytestream.hh>
 #include <fabrique/names.hh>
 #include <fabrique/ast/BinaryOperation.hh>
+#include <fabrique/ast/EvalContext.hh>
 #include <fabrique/ast/Visitor.hh>
+#include <fabrique/dag/Primitive.hh>
 #include <fabrique/types/TypeContext.hh>
 
 #include <cassert>
@@ -132,15 +134,34 @@ void BinaryOperation::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void BinaryOperation::RewriteSubexpressions(const Rewriter& r)
+{
+	r(lhs_);
+	r(rhs_);
+}
+
 
 dag::ValuePtr BinaryOperation::evaluate(EvalContext& ctx) const
 {
 	dag::ValuePtr lhs = lhs_->evaluate(ctx);
-	dag::ValuePtr rhs = rhs_->evaluate(ctx);
-	assert(lhs and rhs);
+	assert(lhs);
 
 	SourceRange loc = source();
 
+	// The logical operators short-circuit: if the left-hand side decides
+	// the result, the right-hand side isn't evaluated.
+	if (op_ == And or op_ == Or)
+	{
+		auto b = std::dynamic_pointer_cast<dag::Boolean>(lhs);
+		if (b and b->value() == (op_ == Or))
+		{
+			return ctx.builder().Bool(b->value(), loc);
+		}
+	}
+
+	dag::ValuePtr rhs = rhs_->evaluate(ctx);
+	assert(rhs);
+
 	switch (op_)
 	{
 		case Divide:    return lhs->DivideBy(rhs, loc);
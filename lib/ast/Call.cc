@@ -30,6 +30,7 @@
  */
 
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/names.hh>
 #include <fabrique/ast/Call.hh>
 #include <fabrique/ast/EvalContext.hh>
@@ -47,7 +48,8 @@ using std::shared_ptr;
 
 
 Call::Call(UniqPtr<Expression> target, UniqPtr<Arguments> arguments, SourceRange src)
-	: Expression(src), target_(std::move(target)), arguments_(std::move(arguments))
+	: Expression(src), target_(std::move(target)), arguments_(std::move(arguments)),
+	  argumentsChecked_(false)
 {
 }
 
@@ -78,10 +80,25 @@ void Call::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Call::RewriteSubexpressions(const Rewriter& r)
+{
+	r(target_);
+	arguments_->RewriteSubexpressions(r);
+}
+
 dag::ValuePtr Call::evaluate(EvalContext& ctx) const
 {
-	Bytestream& dbg = Bytestream::Debug("eval.call");
-	dbg << Bytestream::Action << "calling " << *target_ << "\n";
+	static Bytestream::DebugChannel dbg("eval.call");
+	if (dbg)
+	{
+		dbg << Bytestream::Action << "calling " << *target_ << "\n";
+	}
+
+	Trace::Span span("call");
+	if (span)
+	{
+		span.setName(target_->str());
+	}
 
 	auto target = target_->evaluateAs<dag::Callable>(ctx);
 
@@ -125,6 +142,10 @@ dag::ValuePtr Call::evaluate(EvalContext& ctx) const
 		}
 	}
 
-	target->CheckArguments(args, argLocations, source());
+	if (not argumentsChecked_)
+	{
+		target->CheckArguments(args, argLocations, source());
+	}
+
 	return target->Call(args, ctx.builder(), source());
 }
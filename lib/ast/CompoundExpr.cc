@@ -83,6 +83,14 @@ void CompoundExpression::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void CompoundExpression::RewriteSubexpressions(const Rewriter& r)
+{
+	for (auto& val : values_)
+		val->RewriteSubexpressions(r);
+
+	r(result_);
+}
+
 dag::ValuePtr CompoundExpression::evaluate(EvalContext& ctx) const
 {
 	auto scope(ctx.EnterScope("CompoundExpression"));
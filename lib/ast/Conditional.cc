@@ -73,6 +73,13 @@ void Conditional::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Conditional::RewriteSubexpressions(const Rewriter& r)
+{
+	r(condition_);
+	r(thenClause_);
+	r(elseClause_);
+}
+
 
 dag::ValuePtr Conditional::evaluate(EvalContext& ctx) const
 {
@@ -0,0 +1,186 @@
+//! @file ast/Demand.cc    Definition of @ref fabrique::ast::Demand
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/names.hh>
+#include <fabrique/Bytestream.hh>
+#include <fabrique/ast/ast.hh>
+#include <fabrique/ast/Demand.hh>
+
+#include <unordered_map>
+
+using namespace fabrique;
+using namespace fabrique::ast;
+using std::string;
+using std::vector;
+
+
+Demand::Demand()
+	: mayBuild_(false), functionDepth_(0)
+{
+}
+
+
+vector<bool> Demand::Demanded(const UniqPtrVec<Value>& values,
+                              const vector<string>& requested)
+{
+	const size_t count = values.size();
+
+	std::unordered_map<string, size_t> index;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (auto &name = values[i]->name())
+			index.emplace(name->name(), i);
+	}
+
+	// Find the names that each value refers to and whether it might
+	// create builds: a value whose builds are referred to by filename
+	// rather than by name must still be evaluated.
+	vector<std::unordered_set<string>> references(count);
+	vector<bool> demanded(count, false);
+	vector<size_t> pending;
+
+	auto demand = [&](size_t i)
+	{
+		if (not demanded[i])
+		{
+			demanded[i] = true;
+			pending.push_back(i);
+		}
+	};
+
+	for (size_t i = 0; i < count; i++)
+	{
+		names_.clear();
+		mayBuild_ = false;
+		functionDepth_ = 0;
+		values[i]->Accept(*this);
+		references[i].swap(names_);
+
+		auto &name = values[i]->name();
+		if (not name
+		    or name->name() == names::Subdirectory
+		    or name->name() == names::BuildDirectory
+		    or mayBuild_)
+		{
+			demand(i);
+		}
+	}
+
+	for (const string& name : requested)
+	{
+		auto i = index.find(name);
+		if (i != index.end())
+			demand(i->second);
+	}
+
+	while (not pending.empty())
+	{
+		const size_t i = pending.back();
+		pending.pop_back();
+
+		for (const string& name : references[i])
+		{
+			auto j = index.find(name);
+			if (j != index.end())
+				demand(j->second);
+		}
+	}
+
+	static Bytestream::DebugChannel dbg("ast.demand");
+	if (dbg)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			auto &name = values[i]->name();
+			if (not name)
+				continue;
+
+			dbg
+				<< Bytestream::Action
+				<< (demanded[i] ? "demanded" : "skipping")
+				<< Bytestream::Reset << " " << *name
+				<< "\n"
+				;
+		}
+	}
+
+	return demanded;
+}
+
+
+bool Demand::Enter(const Call& c)
+{
+	// Calling a function or an action from within a function definition
+	// doesn't do anything until the function itself is called.
+	if (functionDepth_ > 0)
+		return true;
+
+	// Some builtins are known not to create builds, but any other call
+	// (to an action, a user-defined function, import(), etc.) might.
+	static const std::unordered_set<string> Harmless = {
+		"fields", "file", "print", "string", "typeof",
+	};
+
+	auto *target = dynamic_cast<const NameReference*>(&c.target());
+	const bool builtin = target and not target->address()
+		and Harmless.find(target->name().name()) != Harmless.end();
+
+	if (not builtin)
+		mayBuild_ = true;
+
+	return true;
+}
+
+
+bool Demand::Enter(const Function&)
+{
+	functionDepth_++;
+	return true;
+}
+
+
+void Demand::Leave(const Function&)
+{
+	functionDepth_--;
+}
+
+
+bool Demand::Enter(const NameReference& r)
+{
+	names_.insert(r.name().name());
+	return true;
+}
+
+
+bool Demand::Enter(const SimpleTypeReference& t)
+{
+	names_.insert(t.name().name());
+	return true;
+}
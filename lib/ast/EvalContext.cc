@@ -58,13 +58,20 @@ using std::string;
 using std::vector;
 
 
-EvalContext::EvalContext(TypeContext& ctx)
-	: ctx_(ctx), builder_(*this)
+EvalContext::EvalContext(TypeContext& ctx, WorkerPool *workers)
+	: ctx_(ctx), speculative_(false), workers_(workers), builder_(*this)
 {
 	// Create top-level scope
 	scopes_.emplace_back(std::make_shared<ScopedValues>("top", nullptr));
 }
 
+EvalContext::EvalContext(TypeContext& ctx, std::deque<string> valueNames)
+	: ctx_(ctx), currentValueName_(std::move(valueNames)), speculative_(true),
+	  workers_(nullptr), builder_(*this)
+{
+	scopes_.emplace_back(std::make_shared<ScopedValues>("top", nullptr));
+}
+
 std::vector<DAG::BuildTarget> EvalContext::Evaluate(const UniqPtrVec<ast::Value>& values)
 {
 	vector<DAG::BuildTarget> topLevelTargets;
@@ -93,7 +100,7 @@ bool EvalContext::ScopedValues::contains(const string& name) const
 
 EvalContext::ScopedValues&
 EvalContext::ScopedValues::Define(const string &name, ValuePtr v, SourceRange src,
-                                  bool allowReservedName)
+                                  bool allowReservedName, Slot slot)
 {
 	if (not src)
 	{
@@ -118,6 +125,16 @@ EvalContext::ScopedValues::Define(const string &name, ValuePtr v, SourceRange sr
 
 	values_.emplace(name, v);
 
+	if (slot != NoSlot)
+	{
+		if (slot >= slots_.size())
+		{
+			slots_.resize(slot + 1);
+		}
+
+		slots_[slot] = v;
+	}
+
 	return *this;
 }
 
@@ -126,13 +143,17 @@ ValuePtr EvalContext::ScopedValues::Lookup(const string& name) const
 	auto i = values_.find(name);
 	if (i != values_.end())
 	{
-		Bytestream::Debug("ast.scope.lookup")
-			<< Bytestream::Action << "  found "
-			<< Bytestream::Literal << "'" << name << "'"
-			<< Bytestream::Operator << ": "
-			<< *i->second
-			<< Bytestream::Reset << "\n"
-			;
+		static Bytestream::DebugChannel dbg("ast.scope.lookup");
+		if (dbg)
+		{
+			dbg
+				<< Bytestream::Action << "  found "
+				<< Bytestream::Literal << "'" << name << "'"
+				<< Bytestream::Operator << ": "
+				<< *i->second
+				<< Bytestream::Reset << "\n"
+				;
+		}
 
 		return i->second;
 	}
@@ -145,6 +166,26 @@ ValuePtr EvalContext::ScopedValues::Lookup(const string& name) const
 	return nullptr;
 }
 
+ValuePtr EvalContext::ScopedValues::Lookup(Address a) const
+{
+	const ScopedValues *scope = this;
+	for (size_t i = 0; i < a.depth; i++)
+	{
+		scope = scope->parent_.get();
+		if (not scope)
+		{
+			return nullptr;
+		}
+	}
+
+	if (a.slot >= scope->slots_.size())
+	{
+		return nullptr;
+	}
+
+	return scope->slots_[a.slot];
+}
+
 void EvalContext::ScopedValues::PrettyPrint(Bytestream &out, unsigned int indent) const
 {
 	const string tabs(indent + 1, '\t');
@@ -197,7 +238,8 @@ bool EvalContext::Scope::contains(const string &name) const
 }
 
 EvalContext::Scope&
-EvalContext::Scope::Define(const string &name, dag::ValuePtr v, SourceRange src)
+EvalContext::Scope::Define(const string &name, dag::ValuePtr v, SourceRange src,
+                           Slot slot)
 {
 	SemaCheck(live_, src, "defining a value in a dead scope");
 	FAB_ASSERT(values_, "Scope has null values_");
@@ -207,7 +249,7 @@ EvalContext::Scope::Define(const string &name, dag::ValuePtr v, SourceRange src)
 		src = v->source();
 	}
 
-	values_->Define(name, v, src);
+	values_->Define(name, v, src, false, slot);
 	return *this;
 }
 
@@ -221,13 +263,17 @@ EvalContext::Scope::DefineReserved(const string &name, dag::ValuePtr value)
 
 	values_->Define(name, value, SourceRange::None(), true);
 
-	Bytestream::Debug("ast.eval.define")
-		<< Bytestream::Action << "Defined "
-		<< Bytestream::Literal << "'" << name << "'"
-		<< Bytestream::Operator << " as "
-		<< *value
-		<< "\n"
-		;
+	static Bytestream::DebugChannel dbg("ast.eval.define");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "Defined "
+			<< Bytestream::Literal << "'" << name << "'"
+			<< Bytestream::Operator << " as "
+			<< *value
+			<< "\n"
+			;
+	}
 
 	return *this;
 }
@@ -242,13 +288,17 @@ shared_ptr<EvalContext::ScopedValues> EvalContext::CurrentScope()
 EvalContext::Scope
 EvalContext::EnterScope(const string& name, shared_ptr<ScopedValues> parent)
 {
-	Bytestream::Debug("ast.eval.scope")
-		<< string(scopes_.size(), ' ')
-		<< Bytestream::Operator << " >> "
-		<< Bytestream::Type << "scope"
-		<< Bytestream::Literal << " '" << name << "'"
-		<< Bytestream::Reset << "\n"
-		;
+	static Bytestream::DebugChannel dbg("ast.eval.scope");
+	if (dbg)
+	{
+		dbg
+			<< string(scopes_.size(), ' ')
+			<< Bytestream::Operator << " >> "
+			<< Bytestream::Type << "scope"
+			<< Bytestream::Literal << " '" << name << "'"
+			<< Bytestream::Reset << "\n"
+			;
+	}
 
 	if (not parent and not scopes_.empty())
 	{
@@ -267,23 +317,31 @@ std::shared_ptr<EvalContext::ScopedValues> EvalContext::PopScope()
 	auto s = std::move(scopes_.back());
 	scopes_.pop_back();
 
-	Bytestream::Debug("ast.eval.scope") << *s << "\n";
+	static Bytestream::DebugChannel dbg("ast.eval.scope");
+	if (dbg)
+	{
+		dbg << *s << "\n";
+	}
 
 	return s;
 }
 
 dag::ValuePtr EvalContext::Define(const ast::Value &v)
 {
-	Bytestream &dbg = Bytestream::Debug("ast.eval.define.reserved");
-	dbg
-		<< Bytestream::Action << "Defining "
-		<< Bytestream::Type << "Value "
-		<< Bytestream::Reset << v
-		<< "\n"
-		;
+	static Bytestream::DebugChannel dbg("ast.eval.define.reserved");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "Defining "
+			<< Bytestream::Type << "Value "
+			<< Bytestream::Reset << v
+			<< "\n"
+			;
 
-	v.source().PrintSource(dbg);
-	dbg << "\n";
+		// Printing source re-reads the source file: only do it when enabled.
+		v.source().PrintSource(dbg.stream());
+		dbg << "\n";
+	}
 
 	const string name = v.name() ? v.name()->name() : "";
 	const bool named = not name.empty();
@@ -296,7 +354,8 @@ dag::ValuePtr EvalContext::Define(const ast::Value &v)
 	dag::ValuePtr value = v.value().evaluate(*this);
 	SemaCheck(value, v.source(), "evaluation returned null");
 
-	if (auto &t = v.explicitType())
+	auto &t = v.explicitType();
+	if (t and not v.explicitTypeChecked())
 	{
 		auto typeRef = t->evaluateAs<dag::TypeReference>(*this);
 		value->type().CheckSubtype(typeRef->referencedType(), v.source());
@@ -304,7 +363,7 @@ dag::ValuePtr EvalContext::Define(const ast::Value &v)
 
 	if (name != "")
 	{
-		Define(name, value);
+		Define(name, value, v.slot());
 
 		FAB_ASSERT(not currentValueName_.empty(), "empty value name stack");
 		FAB_ASSERT(currentValueName_.back() == name,
@@ -314,32 +373,39 @@ dag::ValuePtr EvalContext::Define(const ast::Value &v)
 		currentValueName_.pop_back();
 	}
 
-	dbg
-		<< Bytestream::Action << "Defined "
-		<< Bytestream::Literal << "'" << name << "'"
-		<< Bytestream::Operator << " as "
-		<< *value
-		<< "\n"
-		;
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "Defined "
+			<< Bytestream::Literal << "'" << name << "'"
+			<< Bytestream::Operator << " as "
+			<< *value
+			<< "\n"
+			;
+	}
 
 	return value;
 }
 
-dag::ValuePtr EvalContext::Define(string name, dag::ValuePtr value)
+dag::ValuePtr EvalContext::Define(string name, dag::ValuePtr value, Slot slot)
 {
 	SemaCheck(not name.empty(), value->source(), "defining unnamed value");
 	SemaCheck(value, value->source(), "defining null value");
 
-	CurrentScope()->Define(name, value);
+	CurrentScope()->Define(name, value, SourceRange::None(), false, slot);
 	builder_.Define(fullyQualifiedName(), value);
 
-	Bytestream::Debug("ast.eval.define")
-		<< Bytestream::Action << "Defined "
-		<< Bytestream::Literal << "'" << name << "'"
-		<< Bytestream::Operator << " as "
-		<< *value
-		<< "\n"
-		;
+	static Bytestream::DebugChannel dbg("ast.eval.define");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "Defined "
+			<< Bytestream::Literal << "'" << name << "'"
+			<< Bytestream::Operator << " as "
+			<< *value
+			<< "\n"
+			;
+	}
 
 	return value;
 }
@@ -347,12 +413,15 @@ dag::ValuePtr EvalContext::Define(string name, dag::ValuePtr value)
 
 ValuePtr EvalContext::Lookup(const string& name, SourceRange src)
 {
-	Bytestream& dbg = Bytestream::Debug("ast.lookup");
-	dbg
-		<< Bytestream::Action << "lookup "
-		<< Bytestream::Literal << "'" << name << "'"
-		<< Bytestream::Reset << "\n"
-		;
+	static Bytestream::DebugChannel dbg("ast.lookup");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "lookup "
+			<< Bytestream::Literal << "'" << name << "'"
+			<< Bytestream::Reset << "\n"
+			;
+	}
 
 	// Next, look for lexically-defined names:
 	SemaCheck(not scopes_.empty(), src, "no scopes to lookup in");
@@ -378,6 +447,21 @@ ValuePtr EvalContext::Lookup(const string& name, SourceRange src)
 	throw SemanticException("reference to undefined name", src);
 }
 
+ValuePtr EvalContext::Lookup(const string& name, Address a, SourceRange src)
+{
+	SemaCheck(not scopes_.empty(), src, "no scopes to lookup in");
+	auto s = scopes_.back();
+	FAB_ASSERT(s, "top of scopes_ stack is null");
+
+	if (auto v = s->Lookup(a))
+	{
+		return v;
+	}
+
+	// Forward references and the like are handled (or reported) by name.
+	return Lookup(name, src);
+}
+
 
 string EvalContext::currentValueName() const
 {
@@ -33,6 +33,8 @@
 #include <fabrique/ast/FieldAccess.hh>
 #include <fabrique/ast/Identifier.hh>
 #include <fabrique/ast/Visitor.hh>
+#include <fabrique/dag/Record.hh>
+#include <fabrique/types/RecordShape.hh>
 #include <fabrique/types/Type.hh>
 
 #include <cassert>
@@ -43,7 +45,7 @@ using namespace fabrique::ast;
 
 FieldAccess::FieldAccess(UniqPtr<Expression> base, UniqPtr<Identifier> field)
 	: Expression(SourceRange::Over(base, field)),
-	  base_(std::move(base)), field_(std::move(field))
+	  base_(std::move(base)), field_(std::move(field)), cachedShape_(UINT64_MAX)
 {
 }
 
@@ -69,14 +71,55 @@ void FieldAccess::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void FieldAccess::RewriteSubexpressions(const Rewriter& r)
+{
+	r(base_);
+}
+
 
 dag::ValuePtr FieldAccess::evaluate(EvalContext& ctx) const
 {
 	dag::ValuePtr base = base_->evaluate(ctx);
 	SemaCheck(base->hasFields(), base_->source(), "no fields in " + base->type().str());
 
-	const std::string fieldName(field_->name());
-	dag::ValuePtr field = base->field(fieldName);
+	const std::string &fieldName = field_->name();
+	dag::ValuePtr field;
+
+	//
+	// Records with the same shape keep a field at the same offset, so a
+	// record of the shape we saw last time needs no lookup by name.
+	//
+	if (auto *record = dynamic_cast<const dag::Record*>(base.get()))
+	{
+		const RecordShape &shape = record->shape();
+		const uint64_t cached = cachedShape_.load(std::memory_order_relaxed);
+
+		size_t offset;
+		if ((cached >> 32) == shape.id())
+		{
+			offset = static_cast<size_t>(cached & UINT32_MAX);
+		}
+		else
+		{
+			offset = shape.offset(fieldName);
+			if (offset != RecordShape::NoField)
+			{
+				cachedShape_.store(
+					(static_cast<uint64_t>(shape.id()) << 32) | offset,
+					std::memory_order_relaxed);
+			}
+		}
+
+		if (offset != RecordShape::NoField)
+		{
+			field = record->fieldAt(offset);
+		}
+	}
+	else
+	{
+		field = base->field(fieldName);
+	}
+
 	SemaCheck(field, source(), "no such field in " + base->type().str());
 
 	return field;
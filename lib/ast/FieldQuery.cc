@@ -78,6 +78,12 @@ void FieldQuery::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void FieldQuery::RewriteSubexpressions(const Rewriter& r)
+{
+	r(base_);
+	r(defaultValue_);
+}
+
 
 dag::ValuePtr FieldQuery::evaluate(EvalContext& ctx) const
 {
@@ -95,6 +95,12 @@ void FileList::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void FileList::RewriteSubexpressions(const Rewriter& r)
+{
+	for (auto& a : args_)
+		a->RewriteSubexpressions(r);
+}
+
 dag::ValuePtr FileList::evaluate(EvalContext& ctx) const
 {
 	auto subdir = ctx.Lookup(names::Subdirectory, source());
@@ -30,19 +30,48 @@
  */
 
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
+#include <fabrique/WorkerPool.hh>
 #include <fabrique/ast/EvalContext.hh>
 #include <fabrique/ast/Foreach.hh>
 #include <fabrique/ast/Parameter.hh>
 #include <fabrique/ast/Value.hh>
 #include <fabrique/ast/Visitor.hh>
 #include <fabrique/dag/List.hh>
+#include <fabrique/dag/Owner.hh>
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
+#include <future>
 
 using namespace fabrique;
 using namespace fabrique::ast;
 
 
+namespace {
+
+//! Lists shorter than this aren't worth evaluating in parallel.
+const size_t MinParallelElements = 64;
+
+//! How many chunks of a list to give each worker (to balance the load).
+const size_t ChunksPerWorker = 4;
+
+//! A contiguous range of list elements, evaluated by one worker.
+struct Chunk
+{
+	size_t begin;
+	size_t end;
+
+	std::promise<void> promise;
+	std::exception_ptr failure;
+	std::unique_ptr<EvalContext> eval;
+	SharedPtrVec<dag::Value> results;
+};
+
+} // anonymous namespace
+
+
 ForeachExpr::ForeachExpr(UniqPtr<Identifier> loopVarName,
                          UniqPtr<TypeReference> explicitType,
                          UniqPtr<Expression> inputValue,
@@ -89,36 +118,179 @@ void ForeachExpr::Accept(Visitor& v) const
 		{
 			explicitType_->Accept(v);
 		}
+		inputValue_->Accept(v);
 		body_->Accept(v);
 	}
 
 	v.Leave(*this);
 }
 
+void ForeachExpr::RewriteSubexpressions(const Rewriter& r)
+{
+	r(inputValue_);
+	r(body_);
+}
+
 
 dag::ValuePtr ForeachExpr::evaluate(EvalContext& ctx) const
 {
-	SharedPtrVec<dag::Value> values;
-
 	auto target = sourceSequence().evaluate(ctx);
 	SemaCheck(target->asList(), target->source(),
 	          "cannot iterate over " + target->type().str());
 
+	const dag::List &list = *target->asList();
+	SharedPtrVec<dag::Value> values;
+
+	if (not EvaluateInParallel(list, ctx, values))
+	{
+		for (const dag::ValuePtr& element : list)
+		{
+			values.push_back(EvaluateBody(element, ctx));
+		}
+	}
+
+	return dag::ValuePtr(dag::List::of(values, source(), ctx.types()));
+}
+
+
+dag::ValuePtr ForeachExpr::EvaluateBody(const dag::ValuePtr& element,
+                                        EvalContext& ctx,
+                                        std::shared_ptr<EvalContext::ScopedValues>
+                                          parentScope) const
+{
 	//
-	// For each input element, put its value in scope as the loop parameter
+	// Put the input element in scope as the loop parameter
 	// and then evaluate the CompoundExpression.
 	//
-	auto loopVarName = loopVarName_->name();
-	for (const dag::ValuePtr& element : *target->asList())
+	auto scope(ctx.EnterScope("foreach body", parentScope));
+
+	// The loop variable is the only value in this scope (slot 0).
+	scope.Define(loopVarName_->name(), element,
+	             SourceRange(*loopVarName_, *element), 0);
+
+	dag::ValuePtr result = body_->evaluate(ctx);
+	SemaCheck(result, source(), "invalid foreach body");
+
+	return result;
+}
+
+
+bool ForeachExpr::EvaluateInParallel(const dag::List& list, EvalContext& ctx,
+                                     SharedPtrVec<dag::Value>& results) const
+{
+	WorkerPool *pool = ctx.workers();
+	if (not pool or pool->size() < 2 or list.size() < MinParallelElements)
 	{
-		auto scope(ctx.EnterScope("foreach body"));
-		scope.Define(loopVarName, element, SourceRange(*loopVarName_, *element));
+		return false;
+	}
+
+	Trace::Span span("eval", "parallel foreach");
+	static Bytestream::DebugChannel dbg("ast.foreach");
+
+	const SharedPtrVec<dag::Value> elements(list.begin(), list.end());
+	const size_t count = elements.size();
+	const size_t chunkCount = std::min(count, pool->size() * ChunksPerWorker);
+	const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
 
-		dag::ValuePtr result = body_->evaluate(ctx);
-		SemaCheck(result, source(), "invalid foreach body");
+	//
+	// Each chunk is evaluated in its own (speculative) context, with its
+	// own DAGBuilder, but its scopes are children of the current scope, so
+	// that the body can refer to values from the surrounding code.
+	// Values that the chunk creates are owned by it: it can't modify values
+	// created by other chunks or by the surrounding code.
+	//
+	std::deque<Chunk> chunks(chunkCount);
+	auto parentScope = ctx.CurrentScope();
+	const std::deque<std::string> valueNames = ctx.valueNames();
+	TypeContext &types = ctx.types();
+
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		Chunk &chunk = chunks[i];
+		chunk.begin = std::min(count, i * chunkSize);
+		chunk.end = std::min(count, chunk.begin + chunkSize);
 
-		values.push_back(std::move(result));
+		pool->Submit([this, &chunk, &elements, &types, parentScope, valueNames]()
+		{
+			Trace::Span chunkSpan("eval", "foreach chunk");
+
+			try
+			{
+				dag::Owner owner;
+				chunk.eval.reset(new EvalContext(types, valueNames));
+
+				for (size_t j = chunk.begin; j < chunk.end; j++)
+				{
+					chunk.results.push_back(
+						EvaluateBody(elements[j], *chunk.eval,
+						             parentScope));
+				}
+			}
+			catch (...)
+			{
+				chunk.failure = std::current_exception();
+			}
+
+			chunk.promise.set_value();
+		});
 	}
 
-	return dag::ValuePtr(dag::List::of(values, source(), ctx.types()));
+	// Every chunk refers to our scope and our elements: wait for them all.
+	for (Chunk &chunk : chunks)
+	{
+		chunk.promise.get_future().wait();
+	}
+
+	for (Chunk &chunk : chunks)
+	{
+		if (not chunk.failure)
+		{
+			continue;
+		}
+
+		if (dbg)
+		{
+			std::string problem = "failed";
+			try
+			{
+				std::rethrow_exception(chunk.failure);
+			}
+			catch (const std::exception &e)
+			{
+				problem = e.what();
+			}
+			catch (...)
+			{
+			}
+
+			dbg
+				<< Bytestream::Action << "discarding "
+				<< Bytestream::Type << "parallel foreach"
+				<< Bytestream::Reset << " at "
+				<< Bytestream::Literal << source().str()
+				<< Bytestream::Reset << ": " << problem << "\n"
+				;
+		}
+
+		return false;
+	}
+
+	dbg
+		<< Bytestream::Action << "merging "
+		<< Bytestream::Type << "parallel foreach"
+		<< Bytestream::Reset << " at "
+		<< Bytestream::Literal << source().str()
+		<< Bytestream::Reset << " (" << count << " elements in "
+		<< chunkCount << " chunks)\n"
+		;
+
+	// Combine the chunks in order, as if we'd evaluated them in turn.
+	for (Chunk &chunk : chunks)
+	{
+		ctx.builder().Merge(std::move(chunk.eval->builder()));
+		results.insert(results.end(),
+		               chunk.results.begin(), chunk.results.end());
+	}
+
+	return true;
 }
@@ -32,28 +32,168 @@
 
 #include <fabrique/names.hh>
 #include <fabrique/Bytestream.hh>
+#include <fabrique/ast/Call.hh>
 #include <fabrique/ast/CompoundExpr.hh>
 #include <fabrique/ast/EvalContext.hh>
 #include <fabrique/ast/Function.hh>
+#include <fabrique/ast/NameReference.hh>
 #include <fabrique/ast/Parameter.hh>
 #include <fabrique/ast/Value.hh>
 #include <fabrique/ast/Visitor.hh>
+#include <fabrique/dag/DAGBuilder.hh>
 #include <fabrique/dag/Function.hh>
+#include <fabrique/dag/Hash.hh>
 #include <fabrique/dag/Parameter.hh>
 #include <fabrique/dag/TypeReference.hh>
 #include <fabrique/types/FunctionType.hh>
 #include <fabrique/types/TypeContext.hh>
 
+#include <atomic>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 using namespace fabrique;
 using namespace fabrique::ast;
 
 
+namespace {
+
+//! Looks for expressions with side effects within a function body.
+class PurityCheck : public Visitor
+{
+public:
+	bool pure = true;
+
+	bool Enter(const Action&) override { return (pure = false); }
+	bool Enter(const FileList&) override { return (pure = false); }
+
+	bool Enter(const Call &c) override
+	{
+		if (auto *n = dynamic_cast<const NameReference*>(&c.target()))
+		{
+			const std::string &name = n->name().name();
+			if (name == names::File or name == names::Import
+			    or name == names::Print)
+			{
+				pure = false;
+			}
+		}
+
+		return pure;
+	}
+};
+
+bool IsPure(const Expression &body)
+{
+	PurityCheck check;
+	body.Accept(check);
+	return check.pure;
+}
+
+
+/**
+ * The result of a call to a pure function, together with the named values
+ * that its body defined (relative to the caller's name).
+ */
+struct CallResult
+{
+	dag::ValueMap arguments;
+	dag::ValuePtr result;
+	dag::DAGBuilder::DefinitionLog definitions;
+};
+
+/**
+ * Results of calls to a pure function, indexed by a structural hash of
+ * their arguments.
+ *
+ * A function can be called from several threads at once (e.g., by a parallel
+ * `foreach`), so the cache is protected by a lock.
+ */
+class CallCache
+{
+public:
+	CallCache(SourceRange src)
+		: source_(src), enabled_(true), hits_(0), misses_(0)
+	{
+	}
+
+	bool enabled() const { return enabled_; }
+
+	std::shared_ptr<const CallResult>
+	Lookup(const dag::ValueMap &args, uint64_t hash)
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+
+		auto range = results_.equal_range(hash);
+		for (auto i = range.first; i != range.second; i++)
+		{
+			if (dag::Equivalent(i->second->arguments, args))
+			{
+				hits_++;
+				Report("hit");
+				return i->second;
+			}
+		}
+
+		misses_++;
+		Report("miss");
+		return nullptr;
+	}
+
+	void Store(uint64_t hash, std::shared_ptr<const CallResult> result)
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		if (not enabled_)
+		{
+			return;
+		}
+
+		results_.emplace(hash, std::move(result));
+	}
+
+	//! Stop caching calls: the function turned out to have side effects.
+	void Disable()
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		enabled_ = false;
+		results_.clear();
+		Report("disabled (side effects)");
+	}
+
+private:
+	void Report(const char *event)
+	{
+		static Bytestream::DebugChannel dbg("ast.function.cache");
+		if (dbg)
+		{
+			dbg
+				<< Bytestream::Action << "call cache " << event
+				<< Bytestream::Reset << " for function at "
+				<< Bytestream::Literal << source_.str()
+				<< Bytestream::Reset << " ("
+				<< hits_ << " hits, " << misses_ << " misses)\n"
+				;
+		}
+	}
+
+	const SourceRange source_;
+	std::mutex lock_;
+	std::atomic<bool> enabled_;
+	size_t hits_;
+	size_t misses_;
+	std::unordered_multimap<uint64_t, std::shared_ptr<const CallResult>> results_;
+};
+
+} // anonymous namespace
+
+
 Function::Function(UniqPtrVec<Parameter> params, UniqPtr<TypeReference> resultType,
                    UniqPtr<Expression> body, SourceRange src)
 	: Expression(std::move(src)), HasParameters(params),
-	  resultType_(std::move(resultType)), body_(std::move(body))
+	  resultType_(std::move(resultType)), body_(std::move(body)),
+	  pure_(IsPure(*body_))
 {
 }
 
@@ -105,6 +245,11 @@ void Function::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Function::RewriteSubexpressions(const Rewriter& r)
+{
+	r(body_);
+}
+
 
 dag::ValuePtr Function::evaluate(EvalContext& ctx) const
 {
@@ -122,34 +267,113 @@ dag::ValuePtr Function::evaluate(EvalContext& ctx) const
 	//
 	auto scope = ctx.CurrentScope();
 
+	//
+	// Calls to pure functions are memoized: calling such a function with
+	// structurally-equivalent arguments yields the same result.
+	//
+	auto cache = pure_ ? std::make_shared<CallCache>(source()) : nullptr;
+
 	dag::Function::Evaluator eval =
-		[=,&ctx](const dag::ValueMap args, dag::DAGBuilder&, SourceRange)
+		[=](const dag::ValueMap args, dag::DAGBuilder &builder, SourceRange)
 	{
+		// Evaluate in the caller's context, which may not be the context
+		// that defined the function (e.g., if it was defined by a module
+		// that was imported on another thread).
+		auto &ctx = dynamic_cast<EvalContext&>(builder.context());
+
+		const bool cached = cache and cache->enabled();
+		const uint64_t hash = cached ? dag::Hash(args) : 0;
+		const std::string caller = cached ? ctx.currentValueName() : "";
+
+		if (cached)
+		{
+			if (auto hit = cache->Lookup(args, hash))
+			{
+				// Named values in the body are defined under the
+				// caller's name, just as evaluation would define them.
+				builder.Define(caller, hit->definitions);
+
+				return hit->result;
+			}
+		}
+
 		//
 		// We evaluate the function with the given arguments by
 		// putting default paramters and arguments into the local scope
 		// and then evalating the function's CompoundExpr.
 		//
+		// Parameters are defined in order: the Resolver has assigned
+		// each one the slot corresponding to its position.
+		//
 		auto evalScope(ctx.EnterScope("function call evaluation", scope));
 
+		Slot slot = 0;
+		for (auto& p : parameters)
+		{
+			const std::string &name = p->name();
+			auto i = args.find(name);
+
+			if (i != args.end())
+			{
+				evalScope.Define(name, i->second,
+				                 SourceRange::None(), slot);
+			}
+			else if (dag::ValuePtr v = p->defaultValue())
+			{
+				evalScope.Define(name, v, p->source(), slot);
+			}
+
+			slot++;
+		}
+
 		for (auto& i : args)
 		{
-			evalScope.Define(i.first, i.second);
+			if (not evalScope.contains(i.first))
+			{
+				evalScope.Define(i.first, i.second);
+			}
 		}
 
-		for (auto& p : parameters)
+		using dag::DAGBuilder;
+		UniqPtr<DAGBuilder::DefinitionRecorder> recorder(
+			cached ? new DAGBuilder::DefinitionRecorder(builder) : nullptr);
+
+		const size_t effects = builder.effects();
+		dag::ValuePtr result = body().evaluate(ctx);
+
+		if (cached)
 		{
-			if (dag::ValuePtr v = p->defaultValue())
+			//
+			// Definitions of named values can be replayed on later
+			// calls, but other side effects (e.g., within functions
+			// that we call) can't. Files can be modified after we
+			// return them (e.g., when they become build outputs),
+			// so they can't be shared.
+			//
+			auto call = std::make_shared<CallResult>();
+			call->arguments = args;
+			call->result = result;
+
+			bool reusable = not result->type().hasFiles()
+				and builder.effects() - effects == recorder->log().size()
+				and recorder->Relative(caller, call->definitions);
+
+			for (auto &d : call->definitions)
+			{
+				reusable = reusable and not d.second->type().hasFiles();
+			}
+
+			if (reusable)
+			{
+				cache->Store(hash, call);
+			}
+			else
 			{
-				const std::string &name = p->name();
-				if (not evalScope.contains(name))
-				{
-					evalScope.Define(name, v, p->source());
-				}
+				cache->Disable();
 			}
 		}
 
-		return body().evaluate(ctx);
+		return result;
 	};
 
 	return ctx.builder().Function(eval, ret->referencedType(), parameters, source());
@@ -91,17 +91,19 @@ HasParameters::NameArguments(const vector<string>& args, SourceRange src) const
 {
 	vector<string> namedArgs;
 
-	Bytestream& dbg = Bytestream::Debug("parser.callable");
+	static Bytestream::DebugChannel dbg("parser.callable");
+	if (dbg)
+	{
+		dbg << "matching arguments:\n ";
+		for (auto& a : args)
+			dbg << " " << (a.empty() ? "<unnamed>" : a);
 
-	dbg << "matching arguments:\n ";
-	for (auto& a : args)
-		dbg << " " << (a.empty() ? "<unnamed>" : a);
+		dbg << "\n to parameters:\n ";
+		for (auto& p : params_)
+			dbg << " " << *p;
 
-	dbg << "\n to parameters:\n ";
-	for (auto& p : params_)
-		dbg << " " << *p;
-
-	dbg << "\n";
+		dbg << "\n";
+	}
 
 	bool doneWithPositionalArgs = false;
 	ParamIterator nextParameter = params_.begin();
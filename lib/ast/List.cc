@@ -63,6 +63,12 @@ void List::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void List::RewriteSubexpressions(const Rewriter& r)
+{
+	for (auto& e : elements_)
+		r(e);
+}
+
 
 dag::ValuePtr List::evaluate(EvalContext& ctx) const
 {
@@ -36,7 +36,8 @@ using namespace fabrique::ast;
 
 
 NameReference::NameReference(UniqPtr<Identifier> name)
-	: Expression(name->source()), name_(std::move(name))
+	: Expression(name->source()), name_(std::move(name)),
+	  address_({ 0, NoSlot }), resolved_(false)
 {
 }
 
@@ -57,5 +58,10 @@ void NameReference::PrettyPrint(Bytestream &out, unsigned int indent) const
 
 fabrique::dag::ValuePtr NameReference::evaluate(EvalContext &ctx) const
 {
+	if (resolved_)
+	{
+		return ctx.Lookup(name_->name(), address_, source());
+	}
+
 	return ctx.Lookup(name_->name(), source());
 }
@@ -32,3 +32,5 @@
 #include <fabrique/ast/Node.hh>
 
 fabrique::ast::Node::~Node() {}
+
+void fabrique::ast::Node::RewriteSubexpressions(const Rewriter&) {}
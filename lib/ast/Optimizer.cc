@@ -0,0 +1,352 @@
+//! @file ast/Optimizer.cc    Definition of @ref fabrique::ast::Optimizer
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/names.hh>
+#include <fabrique/AssertionFailure.hh>
+#include <fabrique/Bytestream.hh>
+#include <fabrique/SourceCodeException.hh>
+#include <fabrique/ast/ast.hh>
+#include <fabrique/ast/EvalContext.hh>
+#include <fabrique/ast/Optimizer.hh>
+#include <fabrique/dag/Primitive.hh>
+#include <fabrique/types/TypeContext.hh>
+
+using namespace fabrique;
+using namespace fabrique::ast;
+
+
+namespace {
+
+//! Is an expression a boolean, integer or string literal?
+bool IsLiteral(const Expression &e)
+{
+	return dynamic_cast<const BoolLiteral*>(&e)
+		or dynamic_cast<const IntLiteral*>(&e)
+		or dynamic_cast<const StringLiteral*>(&e);
+}
+
+//! Express a primitive value as a literal (or return null if we can't).
+UniqPtr<Expression> LiteralFrom(const dag::Value &v, const SourceRange &src)
+{
+	if (auto *b = dynamic_cast<const dag::Boolean*>(&v))
+	{
+		return UniqPtr<Expression>(new BoolLiteral(b->value(), src));
+	}
+
+	if (auto *i = dynamic_cast<const dag::Integer*>(&v))
+	{
+		return UniqPtr<Expression>(new IntLiteral(i->value(), src));
+	}
+
+	if (auto *s = dynamic_cast<const dag::String*>(&v))
+	{
+		return UniqPtr<Expression>(new StringLiteral(s->value(), src));
+	}
+
+	return nullptr;
+}
+
+/**
+ * Take one of an expression's subexpressions, leaving a null pointer in its
+ * place: the parent expression must then be discarded.
+ */
+UniqPtr<Expression> Take(Expression &parent, const Expression &child)
+{
+	UniqPtr<Expression> taken;
+	parent.RewriteSubexpressions([&](UniqPtr<Expression> &e)
+	{
+		if (e.get() == &child)
+		{
+			taken = std::move(e);
+		}
+	});
+
+	FAB_ASSERT(taken, "not a subexpression of the expression being rewritten");
+	return taken;
+}
+
+/**
+ * Replace an expression, keeping its static type if nothing more specific
+ * is known about the replacement.
+ */
+void Replace(UniqPtr<Expression> &e, UniqPtr<Expression> replacement)
+{
+	if (not replacement->staticType())
+	{
+		if (const Type *t = e->staticType())
+		{
+			replacement->setStaticType(*t);
+		}
+	}
+
+	e = std::move(replacement);
+}
+
+//! Is an expression a reference to the current module's arguments?
+bool IsArguments(const Expression &e)
+{
+	auto *ref = dynamic_cast<const NameReference*>(&e);
+	return ref and ref->name().name() == names::Arguments;
+}
+
+} // anonymous namespace
+
+
+OptimizationPass::~OptimizationPass()
+{
+}
+
+
+Optimizer& Optimizer::Add(UniqPtr<OptimizationPass> pass)
+{
+	passes_.push_back(std::move(pass));
+	return *this;
+}
+
+
+Optimizer& Optimizer::AddStandardPasses(TypeContext &types)
+{
+	Add(UniqPtr<OptimizationPass>(new ConstantFolding(types)));
+	Add(UniqPtr<OptimizationPass>(new ShortCircuit));
+	Add(UniqPtr<OptimizationPass>(new DeadBranchElimination));
+
+	return *this;
+}
+
+
+void Optimizer::Optimize(const UniqPtrVec<Value> &values)
+{
+	const Node::Rewriter rewrite = [this](UniqPtr<Expression> &e) { Rewrite(e); };
+
+	for (auto &v : values)
+	{
+		v->RewriteSubexpressions(rewrite);
+	}
+}
+
+
+void Optimizer::Rewrite(UniqPtr<Expression> &e)
+{
+	if (not e)
+	{
+		return;
+	}
+
+	e->RewriteSubexpressions([this](UniqPtr<Expression> &sub) { Rewrite(sub); });
+
+	static Bytestream::DebugChannel dbg("ast.optimize");
+
+	for (auto &pass : passes_)
+	{
+		const std::string before = dbg ? e->str() : "";
+		const SourceRange src = e->source();
+
+		if (pass->Rewrite(e) and dbg)
+		{
+			dbg
+				<< Bytestream::Action << pass->name()
+				<< Bytestream::Reset << " at "
+				<< Bytestream::Literal << src.str()
+				<< Bytestream::Reset << ": " << before
+				<< Bytestream::Operator << " => "
+				<< Bytestream::Reset << *e
+				<< "\n"
+				;
+		}
+	}
+}
+
+
+ConstantFolding::ConstantFolding(TypeContext &types)
+	: ctx_(new EvalContext(types))
+{
+}
+
+
+ConstantFolding::~ConstantFolding()
+{
+}
+
+
+bool ConstantFolding::Rewrite(UniqPtr<Expression> &e)
+{
+	bool foldable = false;
+
+	if (auto *op = dynamic_cast<const BinaryOperation*>(e.get()))
+	{
+		foldable = IsLiteral(op->getLHS()) and IsLiteral(op->getRHS());
+	}
+	else if (auto *op = dynamic_cast<const UnaryOperation*>(e.get()))
+	{
+		foldable = IsLiteral(op->getSubExpr());
+	}
+
+	if (not foldable)
+	{
+		return false;
+	}
+
+	dag::ValuePtr value;
+	try
+	{
+		value = e->evaluate(*ctx_);
+	}
+	catch (const SourceCodeException&)
+	{
+		// Leave the error to be reported if and when this is evaluated.
+		return false;
+	}
+
+	UniqPtr<Expression> literal = LiteralFrom(*value, e->source());
+	if (not literal)
+	{
+		return false;
+	}
+
+	Replace(e, std::move(literal));
+	return true;
+}
+
+
+bool ShortCircuit::Rewrite(UniqPtr<Expression> &e)
+{
+	auto *op = dynamic_cast<const BinaryOperation*>(e.get());
+	if (not op)
+	{
+		return false;
+	}
+
+	const BinaryOperation::Operator o = op->getOp();
+	if (o != BinaryOperation::And and o != BinaryOperation::Or)
+	{
+		return false;
+	}
+
+	auto *lhs = dynamic_cast<const BoolLiteral*>(&op->getLHS());
+	if (not lhs)
+	{
+		return false;
+	}
+
+	// `false and x` is false and `true or x` is true:
+	if (lhs->value() == (o == BinaryOperation::Or))
+	{
+		Replace(e, UniqPtr<Expression>(
+			new BoolLiteral(lhs->value(), op->source())));
+		return true;
+	}
+
+	// `true and x` and `false or x` are just x (if x is a boolean):
+	const Expression &rhs = op->getRHS();
+	const Type *t = rhs.staticType();
+	if (not dynamic_cast<const BoolLiteral*>(&rhs)
+	    and not (t and t->isSubtype(t->context().booleanType())))
+	{
+		return false;
+	}
+
+	Replace(e, Take(*e, rhs));
+	return true;
+}
+
+
+bool DeadBranchElimination::Rewrite(UniqPtr<Expression> &e)
+{
+	auto *c = dynamic_cast<const Conditional*>(e.get());
+	if (not c)
+	{
+		return false;
+	}
+
+	auto *condition = dynamic_cast<const BoolLiteral*>(&c->condition());
+	if (not condition)
+	{
+		return false;
+	}
+
+	Replace(e, Take(*e, condition->value() ? c->thenClause() : c->elseClause()));
+	return true;
+}
+
+
+ArgumentPropagation::ArgumentPropagation(const dag::ValueMap &arguments)
+	: arguments_(arguments)
+{
+}
+
+
+bool ArgumentPropagation::Rewrite(UniqPtr<Expression> &e)
+{
+	const Expression *base;
+	const Identifier *field;
+	auto *query = dynamic_cast<const FieldQuery*>(e.get());
+
+	if (query)
+	{
+		base = &query->base();
+		field = &query->field();
+	}
+	else if (auto *access = dynamic_cast<const FieldAccess*>(e.get()))
+	{
+		base = &access->base();
+		field = &access->field();
+	}
+	else
+	{
+		return false;
+	}
+
+	if (not IsArguments(*base))
+	{
+		return false;
+	}
+
+	auto i = arguments_.find(field->name());
+	if (i == arguments_.end())
+	{
+		// `args.foo ? default` is the default if there is no `foo`.
+		if (query)
+		{
+			Replace(e, Take(*e, query->defaultValue()));
+			return true;
+		}
+
+		return false;
+	}
+
+	UniqPtr<Expression> literal = LiteralFrom(*i->second, e->source());
+	if (not literal)
+	{
+		return false;
+	}
+
+	Replace(e, std::move(literal));
+	return true;
+}
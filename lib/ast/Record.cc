@@ -78,6 +78,14 @@ void Record::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Record::RewriteSubexpressions(const Rewriter& r)
+{
+	for (auto& f : fields_)
+	{
+		f->RewriteSubexpressions(r);
+	}
+}
+
 dag::ValuePtr Record::evaluate(EvalContext& ctx) const
 {
 	auto instantiationScope(ctx.EnterScope(names::Record));
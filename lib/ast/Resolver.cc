@@ -0,0 +1,157 @@
+//! @file ast/Resolver.cc    Definition of @ref fabrique::ast::Resolver
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/names.hh>
+#include <fabrique/ast/ast.hh>
+#include <fabrique/ast/Resolver.hh>
+
+using namespace fabrique;
+using namespace fabrique::ast;
+using std::string;
+
+
+void Resolver::Resolve(const UniqPtrVec<Value>& values)
+{
+	scopes_.clear();
+	EnterScope(values);
+	scopes_.pop_back();
+}
+
+
+bool Resolver::Enter(const CompoundExpression& e)
+{
+	EnterScope(e.values());
+	e.result().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool Resolver::Enter(const FileList& f)
+{
+	// File lists get their own (dynamically-populated) scope.
+	scopes_.emplace_back();
+
+	for (auto& a : f.arguments())
+		a->Accept(*this);
+
+	for (auto& file : f)
+		file->Accept(*this);
+
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool Resolver::Enter(const ForeachExpr& f)
+{
+	// The input sequence is evaluated outside of the loop body's scope.
+	f.sourceSequence().Accept(*this);
+
+	scopes_.push_back({ { f.loopVariable().name(), 0 } });
+	f.loopBody().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool Resolver::Enter(const Function& f)
+{
+	// Parameter types and default values are evaluated where the function
+	// is defined, so only the body sees the parameters.
+	LexicalScope parameters;
+	Slot slot = 0;
+	for (auto& p : f.parameters())
+	{
+		p->Accept(*this);
+		parameters.emplace(p->getName().name(), slot++);
+	}
+
+	scopes_.push_back(std::move(parameters));
+	f.body().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool Resolver::Enter(const NameReference& r)
+{
+	const string &name = r.name().name();
+
+	// Reserved names and `subdir` are defined dynamically by Fabrique.
+	if (names::reservedName(name) or name == names::Subdirectory)
+	{
+		return false;
+	}
+
+	size_t depth = 0;
+	for (auto s = scopes_.rbegin(); s != scopes_.rend(); s++, depth++)
+	{
+		auto i = s->find(name);
+		if (i != s->end())
+		{
+			r.resolve({ depth, i->second });
+			break;
+		}
+	}
+
+	return false;
+}
+
+bool Resolver::Enter(const Record& r)
+{
+	EnterScope(r.fields());
+	scopes_.pop_back();
+
+	return false;
+}
+
+
+void Resolver::EnterScope(const UniqPtrVec<Value>& values)
+{
+	LexicalScope scope;
+	Slot slot = 0;
+
+	for (auto& v : values)
+	{
+		if (auto &name = v->name())
+		{
+			v->setSlot(slot);
+			scope.emplace(name->name(), slot++);
+		}
+	}
+
+	scopes_.push_back(std::move(scope));
+
+	for (auto& v : values)
+	{
+		v->Accept(*this);
+	}
+}
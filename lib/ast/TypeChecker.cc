@@ -0,0 +1,724 @@
+//! @file ast/TypeChecker.cc    Definition of @ref fabrique::ast::TypeChecker
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/AssertionFailure.hh>
+#include <fabrique/Bytestream.hh>
+#include <fabrique/names.hh>
+#include <fabrique/ast/ast.hh>
+#include <fabrique/ast/TypeChecker.hh>
+#include <fabrique/types/FileType.hh>
+#include <fabrique/types/FunctionType.hh>
+#include <fabrique/types/RecordType.hh>
+#include <fabrique/types/SequenceType.hh>
+#include <fabrique/types/TypeContext.hh>
+#include <fabrique/types/TypeError.hh>
+
+#include <algorithm>
+
+using namespace fabrique;
+using namespace fabrique::ast;
+using std::string;
+
+
+TypeChecker::TypeChecker(TypeContext &types)
+	: types_(types)
+{
+}
+
+
+void TypeChecker::Check(const UniqPtrVec<Value>& values)
+{
+	scopes_.clear();
+	EnterScope(values);
+	scopes_.pop_back();
+}
+
+
+bool TypeChecker::Enter(const CompoundExpression& e)
+{
+	EnterScope(e.values());
+	e.result().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool TypeChecker::Enter(const FileList& f)
+{
+	// File lists get their own (dynamically-populated) scope.
+	scopes_.emplace_back();
+
+	for (auto& a : f.arguments())
+		a->Accept(*this);
+
+	for (auto& file : f)
+		file->Accept(*this);
+
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool TypeChecker::Enter(const ForeachExpr& f)
+{
+	f.sourceSequence().Accept(*this);
+
+	// Each element of a list is (a subtype of) the list's element type.
+	Binding element;
+	if (auto *t = dynamic_cast<const SequenceType*>(f.sourceSequence().staticType()))
+	{
+		if (t->typeParamCount() == 1)
+		{
+			element.type = &(*t)[0];
+		}
+	}
+
+	scopes_.push_back({ element });
+	f.loopBody().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool TypeChecker::Enter(const Function& f)
+{
+	// Arguments are checked against parameter types when the function
+	// is called, so parameters have (at least) their declared types.
+	LexicalScope parameters;
+	for (auto& p : f.parameters())
+	{
+		p->Accept(*this);
+
+		Binding b;
+		b.type = p->type() ? Resolve(*p->type()) : nullptr;
+		parameters.push_back(b);
+	}
+
+	scopes_.push_back(std::move(parameters));
+	f.body().Accept(*this);
+	scopes_.pop_back();
+
+	return false;
+}
+
+bool TypeChecker::Enter(const Record& r)
+{
+	EnterScope(r.fields());
+	scopes_.pop_back();
+
+	return false;
+}
+
+
+void TypeChecker::Leave(const BinaryOperation& o)
+{
+	const Expression &lhs = o.getLHS(), &rhs = o.getRHS();
+	const Type *l = lhs.staticType(), *r = rhs.staticType();
+	if (not l or not r or not Exact(lhs) or not Exact(rhs))
+	{
+		return;
+	}
+
+	const Type &boolean = types_.booleanType();
+	const Type &integer = types_.integerType();
+	const Type &str = types_.stringType();
+
+	switch (o.getOp())
+	{
+		case BinaryOperation::Add:
+			if (l == &str and r == &str)
+			{
+				SetType(o, str, true);
+				break;
+			}
+			// fall through
+
+		case BinaryOperation::Divide:
+		case BinaryOperation::Multiply:
+		case BinaryOperation::Subtract:
+			if (l == &integer and r == &integer)
+			{
+				SetType(o, integer, true);
+			}
+			break;
+
+		case BinaryOperation::Equal:
+		case BinaryOperation::NotEqual:
+			if (l == &boolean or l == &integer or l == &str)
+			{
+				SetType(o, boolean, true);
+			}
+			break;
+
+		case BinaryOperation::And:
+		case BinaryOperation::Or:
+		case BinaryOperation::Xor:
+			if (l == &boolean)
+			{
+				SetType(o, boolean, true);
+			}
+			break;
+
+		case BinaryOperation::Prefix:
+		case BinaryOperation::Invalid:
+			break;
+	}
+}
+
+void TypeChecker::Leave(const BoolLiteral& b)
+{
+	SetType(b, types_.booleanType(), true);
+}
+
+void TypeChecker::Leave(const Call& c)
+{
+	const Function *fn = FunctionOf(c.target());
+	if (not fn)
+	{
+		return;
+	}
+
+	if (CheckArguments(c, *fn))
+	{
+		c.setArgumentsChecked();
+	}
+
+	// Calling a function yields whatever its body evaluates to.
+	const Expression &body = fn->body();
+	if (const Type *t = body.staticType())
+	{
+		SetType(c, *t, Exact(body));
+	}
+}
+
+void TypeChecker::Leave(const CompoundExpression& e)
+{
+	const Expression &result = e.result();
+	if (const Type *t = result.staticType())
+	{
+		SetType(e, *t, Exact(result));
+	}
+}
+
+void TypeChecker::Leave(const Conditional& c)
+{
+	const Expression &thenClause = c.thenClause(), &elseClause = c.elseClause();
+	const Type *t = thenClause.staticType();
+
+	if (t and t == elseClause.staticType())
+	{
+		SetType(c, *t, Exact(thenClause) and Exact(elseClause));
+	}
+}
+
+void TypeChecker::Leave(const FieldAccess& f)
+{
+	const Expression &base = f.base();
+	auto *t = dynamic_cast<const RecordType*>(base.staticType());
+	if (not t)
+	{
+		return;
+	}
+
+	// Records are covariant, so a field of a record has (a subtype of)
+	// the field type of any of the record's supertypes.
+	auto fields = t->fields();
+	auto i = fields.find(f.field().name());
+	if (i != fields.end())
+	{
+		SetType(f, i->second, Exact(base));
+	}
+}
+
+void TypeChecker::Leave(const FilenameLiteral& f)
+{
+	SetType(f, types_.fileType(), true);
+}
+
+void TypeChecker::Leave(const ForeachExpr& f)
+{
+	const Expression &body = f.loopBody();
+	const Type *t = body.staticType();
+	if (not t or not Exact(body))
+	{
+		return;
+	}
+
+	//
+	// The result is a list of the body's type, unless there were no
+	// elements to iterate over (the empty list is a subtype of any list).
+	// Only lists that have an element type are known to be non-empty.
+	//
+	const Expression &source = f.sourceSequence();
+	const Type *sourceType = source.staticType();
+	const bool nonEmpty = sourceType and Exact(source)
+		and sourceType->isOrdered() and sourceType->typeParamCount() == 1;
+
+	SetType(f, Type::ListOf(*t), nonEmpty);
+}
+
+void TypeChecker::Leave(const Function& f)
+{
+	PtrVec<Type> parameterTypes;
+	for (auto& p : f.parameters())
+	{
+		const Type *t = p->type() ? Resolve(*p->type()) : nullptr;
+		if (not t)
+		{
+			return;
+		}
+
+		parameterTypes.push_back(t);
+	}
+
+	const Type *resultType = f.resultType() ? Resolve(*f.resultType()) : nullptr;
+	if (not resultType)
+	{
+		return;
+	}
+
+	SetType(f, types_.functionType(parameterTypes, *resultType), true);
+}
+
+void TypeChecker::Leave(const IntLiteral& i)
+{
+	SetType(i, types_.integerType(), true);
+}
+
+void TypeChecker::Leave(const List& l)
+{
+	if (l.elements().empty())
+	{
+		SetType(l, types_.emptyList(), true);
+		return;
+	}
+
+	// We only know the element type of a list whose elements' types are
+	// all exactly the same.
+	const Type *elementType = l.elements().front()->staticType();
+	for (auto& e : l.elements())
+	{
+		if (not e->staticType() or e->staticType() != elementType
+		    or not Exact(*e))
+		{
+			return;
+		}
+	}
+
+	SetType(l, Type::ListOf(*elementType), true);
+}
+
+void TypeChecker::Leave(const NameReference& r)
+{
+	const Binding *b = Lookup(r);
+	if (b and b->type)
+	{
+		SetType(r, *b->type, b->exact);
+	}
+}
+
+void TypeChecker::Leave(const Record& r)
+{
+	// Record types are built from fields in name order, as at evaluation.
+	StringMap<const Value*> fields;
+	for (auto& f : r.fields())
+	{
+		if (not f->name() or not f->staticType()
+		    or not fields.emplace(f->name()->name(), f.get()).second)
+		{
+			return;
+		}
+	}
+
+	Type::NamedTypeVec fieldTypes;
+	bool exact = true;
+	for (auto& f : fields)
+	{
+		fieldTypes.emplace_back(f.first, *f.second->staticType());
+		exact = exact and Exact(*f.second);
+	}
+
+	SetType(r, types_.recordType(fieldTypes), exact);
+}
+
+void TypeChecker::Leave(const StringLiteral& s)
+{
+	SetType(s, types_.stringType(), true);
+}
+
+void TypeChecker::Leave(const UnaryOperation& o)
+{
+	const Expression &subexpr = o.getSubExpr();
+	const Type *t = subexpr.staticType();
+	if (not t)
+	{
+		return;
+	}
+
+	switch (o.getOp())
+	{
+		case UnaryOperation::Plus:
+			SetType(o, *t, Exact(subexpr));
+			break;
+
+		case UnaryOperation::Minus:
+			if (t == &types_.integerType())
+			{
+				SetType(o, *t, true);
+			}
+			break;
+
+		case UnaryOperation::LogicalNot:
+			if (t == &types_.booleanType())
+			{
+				SetType(o, *t, true);
+			}
+			break;
+
+		case UnaryOperation::Invalid:
+			break;
+	}
+}
+
+void TypeChecker::Leave(const Value& v)
+{
+	const Expression &e = v.value();
+	const Type *t = e.staticType();
+	bool exact = t and Exact(e);
+
+	if (auto &ref = v.explicitType())
+	{
+		const Type *explicitType = Resolve(*ref);
+
+		if (t and explicitType)
+		{
+			if (explicitType->isSupertype(*t))
+			{
+				v.setExplicitTypeChecked();
+			}
+			else if (exact)
+			{
+				// This is exactly what evaluation would report.
+				t->CheckSubtype(*explicitType, v.source());
+			}
+		}
+
+		// Evaluation checks values against their explicit types.
+		if (explicitType and not v.explicitTypeChecked())
+		{
+			t = explicitType;
+			exact = false;
+		}
+	}
+
+	if (t)
+	{
+		SetType(v, *t, exact);
+	}
+
+	if (v.name())
+	{
+		FAB_ASSERT(not scopes_.empty(), "defining value outside of any scope");
+
+		LexicalScope &scope = scopes_.back();
+		if (v.slot() < scope.size())
+		{
+			Binding &b = scope[v.slot()];
+			b.type = t;
+			b.exact = t and Exact(v);
+			b.function = FunctionOf(e);
+		}
+	}
+}
+
+
+void TypeChecker::EnterScope(const UniqPtrVec<Value>& values)
+{
+	size_t named = 0;
+	for (auto& v : values)
+	{
+		if (v->name())
+		{
+			named++;
+		}
+	}
+
+	scopes_.emplace_back(named);
+
+	for (auto& v : values)
+	{
+		v->Accept(*this);
+	}
+}
+
+const TypeChecker::Binding* TypeChecker::Lookup(const NameReference& r) const
+{
+	const Address *a = r.address();
+	if (not a or a->depth >= scopes_.size())
+	{
+		return nullptr;
+	}
+
+	const LexicalScope &scope = scopes_[scopes_.size() - 1 - a->depth];
+	if (a->slot >= scope.size())
+	{
+		return nullptr;
+	}
+
+	return &scope[a->slot];
+}
+
+
+void TypeChecker::SetType(const Expression &e, const Type &t, bool exact)
+{
+	e.setStaticType(t);
+
+	// Values of these types can't have any other (sub)type.
+	if (exact or &t == &types_.booleanType() or &t == &types_.integerType()
+	    or &t == &types_.stringType())
+	{
+		exact_.insert(&e);
+	}
+}
+
+bool TypeChecker::Exact(const Expression &e) const
+{
+	return exact_.find(&e) != exact_.end();
+}
+
+
+const Type* TypeChecker::Resolve(const TypeReference &ref)
+{
+	auto cached = resolved_.find(&ref);
+	if (cached != resolved_.end())
+	{
+		return cached->second;
+	}
+
+	//
+	// Resolve the same way that evaluation does, except that user-defined
+	// type names can only be known by evaluating them.
+	//
+	const Type *t = nullptr;
+
+	if (auto *simple = dynamic_cast<const SimpleTypeReference*>(&ref))
+	{
+		if (simple->name().reservedName())
+		{
+			t = &types_.find(simple->name().name());
+		}
+	}
+	else if (auto *p = dynamic_cast<const ParametricTypeReference*>(&ref))
+	{
+		const Type *base = Resolve(p->base());
+
+		PtrVec<Type> parameters;
+		for (auto &param : p->parameters())
+		{
+			parameters.push_back(Resolve(*param));
+		}
+
+		const bool known = base and not parameters.empty()
+			and std::find(parameters.begin(), parameters.end(), nullptr)
+				== parameters.end();
+
+		if (known)
+		{
+			t = &types_.find(base->name(), parameters);
+		}
+	}
+	else if (auto *fn = dynamic_cast<const FunctionTypeReference*>(&ref))
+	{
+		PtrVec<Type> parameters;
+		for (auto &param : fn->parameters())
+		{
+			parameters.push_back(Resolve(*param));
+		}
+
+		const Type *result = Resolve(fn->resultType());
+		const bool known = result
+			and std::find(parameters.begin(), parameters.end(), nullptr)
+				== parameters.end();
+
+		if (known)
+		{
+			t = &types_.functionType(parameters, *result);
+		}
+	}
+	else if (auto *r = dynamic_cast<const RecordTypeReference*>(&ref))
+	{
+		Type::NamedTypeVec fields;
+		for (auto &f : r->fields())
+		{
+			const Type *fieldType = Resolve(*f.second);
+			if (not fieldType)
+			{
+				fields.clear();
+				break;
+			}
+
+			fields.emplace_back(f.first->name(), *fieldType);
+		}
+
+		if (not fields.empty() or r->fields().empty())
+		{
+			t = &types_.recordType(fields);
+		}
+	}
+
+	// Invalid (and nil) types are left for evaluation to report.
+	if (t and not *t)
+	{
+		t = nullptr;
+	}
+
+	resolved_.emplace(&ref, t);
+	return t;
+}
+
+
+const Function* TypeChecker::FunctionOf(const Expression &e) const
+{
+	if (auto *fn = dynamic_cast<const Function*>(&e))
+	{
+		return fn;
+	}
+
+	if (auto *ref = dynamic_cast<const NameReference*>(&e))
+	{
+		// Calls to file() and import() get an implicit `subdir` argument.
+		const string &name = ref->name().name();
+		if (name == names::File or name == names::Import)
+		{
+			return nullptr;
+		}
+
+		if (const Binding *b = Lookup(*ref))
+		{
+			return b->function;
+		}
+	}
+
+	return nullptr;
+}
+
+
+bool TypeChecker::CheckArguments(const Call &c, const Function &fn)
+{
+	const UniqPtrVec<Parameter> &params = fn.parameters();
+	const Arguments &args = c.arguments();
+
+	//
+	// Name the arguments as evaluation would, giving up on anything that
+	// evaluation would report an error about before checking types.
+	//
+	StringMap<std::pair<const Expression*, SourceRange>> named;
+
+	size_t position = 0;
+	for (auto &a : args.positional())
+	{
+		if (position >= params.size())
+		{
+			return false;
+		}
+
+		const string &name = params[position++]->getName().name();
+		named.emplace(name, std::make_pair(a.get(), a->source()));
+	}
+
+	for (auto &a : args.keyword())
+	{
+		const Expression &value = a->getValue();
+		auto arg = std::make_pair(&value, SourceRange::Over(a, &value));
+
+		if (not named.emplace(a->getName().name(), arg).second)
+		{
+			return false;
+		}
+	}
+
+	for (auto &a : named)
+	{
+		if (fn.parameterNames().count(a.first) == 0)
+		{
+			return false;
+		}
+	}
+
+	//
+	// Check arguments against parameters in the same order as evaluation.
+	//
+	bool proven = true;
+	for (auto &p : params)
+	{
+		auto i = named.find(p->getName().name());
+		if (i == named.end())
+		{
+			if (p->defaultValue())
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		const Expression &arg = *i->second.first;
+		const Type *argType = arg.staticType();
+		const Type *paramType = p->type() ? Resolve(*p->type()) : nullptr;
+
+		if (not argType or not paramType)
+		{
+			proven = false;
+		}
+		else if (not paramType->isSupertype(*argType))
+		{
+			if (Exact(arg))
+			{
+				// This is exactly what evaluation would report.
+				argType->CheckSubtype(*paramType, i->second.second);
+			}
+
+			proven = false;
+		}
+	}
+
+	static Bytestream::DebugChannel dbg("ast.typecheck");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action
+			<< (proven ? "proved" : "could not prove")
+			<< Bytestream::Reset << " argument types for call "
+			<< c << "\n"
+			;
+	}
+
+	return proven;
+}
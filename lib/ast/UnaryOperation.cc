@@ -95,6 +95,11 @@ void UnaryOperation::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void UnaryOperation::RewriteSubexpressions(const Rewriter& r)
+{
+	r(subexpr_);
+}
+
 
 dag::ValuePtr UnaryOperation::evaluate(EvalContext& ctx) const
 {
@@ -48,7 +48,7 @@ using std::string;
 
 
 Value::Value()
-	: Expression(SourceRange::None())
+	: Expression(SourceRange::None()), slot_(NoSlot), typeChecked_(false)
 {
 }
 
@@ -56,7 +56,7 @@ Value::Value(UniqPtr<Identifier> id, UniqPtr<TypeReference> explicitType,
              UniqPtr<Expression> value)
 	: Expression(SourceRange::Over(id, value)),
 	  name_(std::move(id)), explicitType_(std::move(explicitType)),
-	  value_(std::move(value))
+	  value_(std::move(value)), slot_(NoSlot), typeChecked_(false)
 {
 	SemaCheck(not explicitType_ or name_, source(), "explicit type requires a name");
 }
@@ -99,6 +99,11 @@ void Value::Accept(Visitor& v) const
 	v.Leave(*this);
 }
 
+void Value::RewriteSubexpressions(const Rewriter& r)
+{
+	r(value_);
+}
+
 
 dag::ValuePtr Value::evaluate(EvalContext& ctx) const
 {
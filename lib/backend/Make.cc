@@ -250,7 +250,7 @@ void MakeBackend::Process(const dag::DAG& dag, Bytestream& out, ErrorReport::Rep
 		// a pseudo-target that points to all outputs.
 		//
 
-		FileVec outputs = build.outputs();
+		const FileVec& outputs = build.outputs();
 		if (outputs.size() > 1)
 		{
 			const string pseudoName =
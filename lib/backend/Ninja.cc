@@ -157,12 +157,19 @@ void NinjaBackend::Process(const dag::DAG& dag, Bytestream& out,
 			<< Bytestream::Reset << "\n"
 			;
 
+		// The regeneration rule only rewrites files whose contents have
+		// changed, so Ninja should re-stat its outputs rather than assuming
+		// that everything downstream of them needs to be rebuilt.
 		if (rule.name() == Rule::RegenerationRuleName())
 			out
 				<< Bytestream::Definition << "  generator"
 				<< Bytestream::Operator << " = "
 				<< Bytestream::Literal << "true"
 				<< Bytestream::Reset << "\n"
+				<< Bytestream::Definition << "  restat"
+				<< Bytestream::Operator << " = "
+				<< Bytestream::Literal << "1"
+				<< Bytestream::Reset << "\n"
 				;
 
 		// Check for use of reserved names (e.g., 'command', 'description')
@@ -31,10 +31,20 @@
 #include <fabrique/builtins.hh>
 #include <fabrique/names.hh>
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
+#include <fabrique/WorkerPool.hh>
+#include <fabrique/ast/Call.hh>
 #include <fabrique/ast/EvalContext.hh>
+#include <fabrique/ast/NameReference.hh>
+#include <fabrique/ast/Value.hh>
+#include <fabrique/ast/Visitor.hh>
+#include <fabrique/ast/literals.hh>
 #include <fabrique/dag/DAGBuilder.hh>
 #include <fabrique/dag/File.hh>
+#include <fabrique/dag/Hash.hh>
+#include <fabrique/dag/Owner.hh>
 #include <fabrique/dag/Parameter.hh>
+#include <fabrique/dag/Primitive.hh>
 #include <fabrique/dag/TypeReference.hh>
 #include <fabrique/parsing/Parser.hh>
 #include <fabrique/plugin/Loader.hh>
@@ -44,7 +54,14 @@
 #include <fabrique/types/FileType.hh>
 #include <fabrique/types/TypeContext.hh>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
 
 using namespace fabrique;
 using namespace fabrique::builtins;
@@ -86,6 +103,10 @@ static ValuePtr OpenFileImpl(ValueMap arguments, DAGBuilder &b, SourceRange src)
 
 static ValuePtr PrintImpl(ValueMap arguments, DAGBuilder &b, SourceRange src)
 {
+	// Output can't be taken back if speculative evaluation is discarded.
+	auto &ctx = dynamic_cast<ast::EvalContext&>(b.context());
+	SemaCheck(not ctx.speculative(), src, "cannot print speculatively");
+
 	Bytestream &out = Bytestream::Stdout();
 
 	auto v = arguments["value"];
@@ -102,6 +123,7 @@ static ValuePtr PrintImpl(ValueMap arguments, DAGBuilder &b, SourceRange src)
 	}
 
 	out << Bytestream::Reset << "\n";
+	b.NoteEffect();
 
 	return v;
 }
@@ -111,6 +133,12 @@ static ValuePtr StringifyImpl(ValueMap arguments, DAGBuilder &b, SourceRange src
 	auto v = arguments["value"];
 	SemaCheck(v, src, "null value");
 
+	// Strings are immutable, so they can stringify to themselves.
+	if (std::dynamic_pointer_cast<String>(v))
+	{
+		return v;
+	}
+
 	return b.String(v->str(), src);
 }
 
@@ -144,9 +172,301 @@ fabrique::dag::ValuePtr fabrique::builtins::OpenFile(fabrique::dag::DAGBuilder &
 }
 
 
-static std::shared_ptr<Record>
-ImportFile(string filename, string subdir, ValueMap arguments, SourceRange src,
-           parsing::Parser &p, ast::EvalContext &eval, Bytestream &dbg)
+namespace {
+
+//! Finds references to names that a module does not define itself.
+class FreeNameFinder : public ast::Visitor
+{
+public:
+	bool found = false;
+
+	bool Enter(const ast::NameReference &n) override
+	{
+		const string &name = n.name().name();
+		if (not n.address() and not names::reservedName(name)
+		    and name != names::Subdirectory)
+		{
+			found = true;
+		}
+
+		return false;
+	}
+};
+
+/**
+ * Modules that have already been evaluated.
+ *
+ * A module that only refers to its own values, builtins and its arguments
+ * evaluates to the same record every time it is imported from the same
+ * subdirectory with equivalent arguments. Other modules can see values from
+ * the scope they are imported into, so they are re-evaluated every time.
+ *
+ * A module's values are defined in the DAG under the name of the value that
+ * imports it, so we keep those definitions (relative to that name) in order
+ * to define them again under the name of each later importer.
+ */
+struct ImportCache
+{
+	struct Module
+	{
+		ValueMap arguments;
+		std::shared_ptr<Record> record;
+		DAGBuilder::DefinitionLog definitions;
+	};
+
+	//! Modules indexed by (filename, subdirectory, argument hash).
+	std::multimap<std::tuple<string, string, uint64_t>, Module> modules;
+
+	//! Whether each file refers only to names it defines itself.
+	StringMap<bool> selfContained;
+};
+
+} // anonymous namespace
+
+
+namespace {
+
+/**
+ * The implementation of `import()`.
+ *
+ * When given a pool of worker threads, an importer looks ahead in the file
+ * that is calling it for other values defined as `import('subdirectory')`
+ * and evaluates those modules speculatively, each in its own context.
+ * When a module is actually imported, its speculative evaluation is only
+ * used if it is known to be what serial evaluation would have produced;
+ * its results are then merged as if it had been evaluated at that point,
+ * so the DAG is the same no matter how many threads were used.
+ */
+class Importer : public std::enable_shared_from_this<Importer>
+{
+public:
+	//! Import modules for a top-level context.
+	Importer(parsing::Parser&, plugin::Loader&, string srcroot, WorkerPool*);
+
+	//! Import modules speculatively, with our own parser.
+	Importer(TypeContext&, plugin::Loader&, string srcroot);
+
+	//! Create an `import()` function that calls this importer.
+	ValuePtr Function(DAGBuilder&);
+
+	ValuePtr Import(ValueMap arguments, DAGBuilder&, SourceRange);
+
+private:
+	using Key = std::tuple<string, string, uint64_t>;
+
+	//! A module that is being (or has been) imported speculatively.
+	struct Speculation
+	{
+		//! Set by whichever thread starts evaluating the module first.
+		std::atomic<bool> claimed;
+
+		//! The value names that serial evaluation would have on its stack.
+		std::deque<string> valueNames;
+
+		std::promise<void> promise;
+		std::future<void> done;
+
+		std::exception_ptr failure;
+		std::unique_ptr<ast::EvalContext> eval;
+		std::shared_ptr<Importer> importer;
+		std::shared_ptr<Record> record;
+	};
+
+	std::shared_ptr<Record>
+	ImportFile(string filename, string subdir, ValueMap arguments,
+	           SourceRange, ast::EvalContext&, Bytestream &dbg);
+
+	/**
+	 * Start speculatively importing the subdirectories imported by values
+	 * after the one containing @a src.
+	 */
+	void Prefetch(SourceRange src, const string &subdir, ast::EvalContext&);
+
+	/**
+	 * Take the result of speculatively importing a module, if there is
+	 * one and it is exactly what importing the module now would produce.
+	 */
+	std::shared_ptr<Record>
+	Speculated(const Key&, const ValueMap &arguments, ast::EvalContext&,
+	           Bytestream &dbg);
+
+	std::unique_ptr<parsing::Parser> ownParser_;
+	parsing::Parser *parser_;
+	plugin::Loader &loader_;
+	const string srcroot_;
+	WorkerPool *pool_;
+	const bool speculative_;
+
+	ImportCache cache_;
+
+	//! Files (and subdirectories) that we have looked ahead in.
+	std::set<std::pair<string, string>> scanned_;
+
+	std::map<Key, std::shared_ptr<Speculation>> speculations_;
+
+	/**
+	 * Once a speculative importer's results have been merged, any calls
+	 * to it (e.g., from functions defined by its modules) belong to the
+	 * importer that it was working on behalf of.
+	 */
+	std::shared_ptr<Importer> delegate_;
+};
+
+/**
+ * Plugins are not expected to be thread-safe, so only one thread may look
+ * up, load or instantiate a plugin at a time.
+ */
+std::mutex& pluginLock()
+{
+	static std::mutex& lock = *new std::mutex;
+	return lock;
+}
+
+} // anonymous namespace
+
+
+Importer::Importer(parsing::Parser &p, plugin::Loader &loader, string srcroot,
+                   WorkerPool *pool)
+	: parser_(&p), loader_(loader), srcroot_(srcroot), pool_(pool),
+	  speculative_(false)
+{
+}
+
+
+Importer::Importer(TypeContext &types, plugin::Loader &loader, string srcroot)
+	: ownParser_(new parsing::Parser(types, false, false)), parser_(ownParser_.get()),
+	  loader_(loader), srcroot_(srcroot), pool_(nullptr), speculative_(true)
+{
+}
+
+
+ValuePtr Importer::Function(DAGBuilder &b)
+{
+	TypeContext &types = b.typeContext();
+
+	SharedPtrVec<dag::Parameter> params;
+	params.emplace_back(new Parameter("module", types.stringType()));
+
+	auto self = shared_from_this();
+
+	dag::Function::Evaluator import =
+		[self](ValueMap arguments, DAGBuilder &builder, SourceRange src)
+	{
+		return self->Import(arguments, builder, src);
+	};
+
+	return b.Function(import, types.nilType(), params,
+	                  SourceRange::None(), true);
+}
+
+
+ValuePtr Importer::Import(ValueMap arguments, DAGBuilder &builder, SourceRange src)
+{
+	// Importing shares our caches (and may load plugins), so it can't be
+	// done from code being evaluated speculatively on another thread
+	// (e.g., a parallel foreach body) unless we are its own importer.
+	SemaCheck(speculative_ or not
+	          dynamic_cast<ast::EvalContext&>(builder.context()).speculative(),
+	          src, "cannot import speculatively");
+
+	if (delegate_)
+	{
+		return delegate_->Import(arguments, builder, src);
+	}
+
+	Bytestream &dbg = speculative_ ? Bytestream::None()
+	                               : Bytestream::Debug("module.import");
+
+	auto &eval = dynamic_cast<ast::EvalContext&>(builder.context());
+
+	auto n = arguments["module"];
+	SemaCheck(n, src, "missing module or file name");
+	arguments.erase("module");
+	const string name = n->str();
+
+	Trace::Span span("import", name);
+
+	auto s = arguments[names::Subdirectory];
+	SemaCheck(s, src, "missing subdir");
+	arguments.erase(names::Subdirectory);
+
+	auto currentSubdir = std::dynamic_pointer_cast<dag::File>(s);
+	SemaCheck(currentSubdir, src, "subdir is not a File");
+
+	dbg
+		<< Bytestream::Action << "importing "
+		<< Bytestream::Operator << "'"
+		<< Bytestream::Literal << name
+		<< Bytestream::Operator << "'"
+		<< Bytestream::Reset << " from subdir '"
+		<< Bytestream::Literal << *currentSubdir
+		<< Bytestream::Reset << "'...\n"
+		;
+
+	if (pool_)
+	{
+		Prefetch(src, currentSubdir->str(), eval);
+	}
+
+	const string filename = PathIsAbsolute(name)
+		? name
+		: JoinPath({ srcroot_, currentSubdir->str(), name })
+		;
+
+	if (PathIsFile(filename))
+	{
+		const string subdir =
+			JoinPath(currentSubdir->str(), DirectoryOf(name));
+
+		return ImportFile(filename, subdir, arguments, src, eval, dbg);
+	}
+
+	if (PathIsDirectory(filename))
+	{
+		const string subdir = JoinPath(currentSubdir->str(), name);
+		const string fabfile = JoinPath(filename, "fabfile");
+
+		SemaCheck(PathIsFile(fabfile), src,
+		          "directory does not contain 'fabfile'");
+
+		return ImportFile(fabfile, subdir, arguments, src, eval, dbg);
+	}
+
+	std::lock_guard<std::mutex> lock(pluginLock());
+
+	auto descriptor = plugin::Registry::get().lookup(name).lock();
+	if (not descriptor)
+	{
+		// Loading a plugin is visible outside of the DAG (it becomes an
+		// input of the generation cache), so it must happen in order.
+		SemaCheck(not speculative_, src,
+		          "cannot load plugin '" + name + "' speculatively");
+
+		descriptor = loader_.Load(name).lock();
+	}
+	SemaCheck(descriptor, n->source(),
+		"no such file or plugin ('" + name + "')");
+
+	auto plugin = descriptor->Create(builder, arguments);
+	SemaCheck(plugin, src, "failed to create plugin with arguments");
+
+	dbg
+		<< Bytestream::Action << "instantiated "
+		<< Bytestream::Type << "plugin"
+		<< Bytestream::Operator << "'"
+		<< Bytestream::Literal << name
+		<< Bytestream::Operator << "': "
+		<< Bytestream::Reset << plugin->type()
+		<< "\n"
+		;
+
+	return plugin;
+}
+
+
+std::shared_ptr<Record>
+Importer::ImportFile(string filename, string subdir, ValueMap arguments,
+                     SourceRange src, ast::EvalContext &eval, Bytestream &dbg)
 {
 	dbg
 		<< Bytestream::Action << "importing "
@@ -159,6 +479,36 @@ ImportFile(string filename, string subdir, ValueMap arguments, SourceRange src,
 		<< Bytestream::Reset << "\n"
 		;
 
+	const string importer = eval.currentValueName();
+	const auto key = std::make_tuple(filename, subdir, dag::Hash(arguments));
+	auto previous = cache_.modules.equal_range(key);
+	for (auto i = previous.first; i != previous.second; i++)
+	{
+		if (dag::Equivalent(i->second.arguments, arguments))
+		{
+			dbg
+				<< Bytestream::Action << "reusing "
+				<< Bytestream::Type << "module"
+				<< Bytestream::Operator << " '"
+				<< Bytestream::Literal << filename
+				<< Bytestream::Operator << "'"
+				<< Bytestream::Reset << " from "
+				<< Bytestream::Literal << subdir
+				<< Bytestream::Reset << "\n"
+				;
+
+			eval.builder().Define(importer, i->second.definitions);
+			return i->second.record;
+		}
+	}
+
+	if (auto record = Speculated(key, arguments, eval, dbg))
+	{
+		return record;
+	}
+
+	const ValueMap moduleArguments = arguments;
+
 	DAGBuilder &b = eval.builder();
 	auto sub = b.File(subdir);
 	arguments[names::Subdirectory] = sub;
@@ -171,14 +521,34 @@ ImportFile(string filename, string subdir, ValueMap arguments, SourceRange src,
 	std::ifstream infile(filename.c_str());
 	SemaCheck(infile, src, "failed to open '" + filename + "'");
 
-	auto parse = p.ParseFile(infile, filename);
-	for (auto &e : parse.errors())
+	auto parse = parser_->ParseFile(infile, filename);
+
+	// Errors will be reported if and when the import happens for real.
+	if (not speculative_)
 	{
-		Bytestream::Stderr() << e << "\n";
+		for (auto &e : parse.errors())
+		{
+			Bytestream::Stderr() << e << "\n";
+		}
 	}
 
 	SemaCheck(parse, src, "failed to import '" + filename + "'");
 
+	auto selfContained = cache_.selfContained.find(filename);
+	if (selfContained == cache_.selfContained.end())
+	{
+		FreeNameFinder finder;
+		for (auto &v : parse.ok())
+		{
+			v->Accept(finder);
+		}
+
+		selfContained =
+			cache_.selfContained.emplace(filename, not finder.found).first;
+	}
+
+	DAGBuilder::DefinitionRecorder recorder(b);
+
 	ValueMap values;
 	for (auto &v : parse.ok())
 	{
@@ -189,100 +559,253 @@ ImportFile(string filename, string subdir, ValueMap arguments, SourceRange src,
 		}
 	}
 
-	return b.Record(values, src);
+	auto record = b.Record(values, src);
+
+	ImportCache::Module module { moduleArguments, record, {} };
+	if (selfContained->second and recorder.Relative(importer, module.definitions))
+	{
+		cache_.modules.emplace(key, std::move(module));
+	}
+
+	return record;
 }
 
 
-ValuePtr
-fabrique::builtins::Import(parsing::Parser &p, plugin::Loader &pluginLoader,
-                           string srcroot, ast::EvalContext &eval)
+void Importer::Prefetch(SourceRange src, const string &subdir,
+                        ast::EvalContext &eval)
 {
-	FAB_ASSERT(PathIsAbsolute(srcroot), "srcroot must be an absolute path");
+	const string filename = src.filename();
+	if (not parser_->hasParseTree(filename)
+	    or not scanned_.emplace(filename, subdir).second)
+	{
+		return;
+	}
 
-	DAGBuilder &b = eval.builder();
-	TypeContext &types = b.typeContext();
+	//
+	// We can only predict the value names that a module will be evaluated
+	// under if we're being called from a top-level value's definition.
+	//
+	const auto &valueNames = eval.valueNames();
+	if (valueNames.empty())
+	{
+		return;
+	}
 
-	SharedPtrVec<dag::Parameter> params;
-	params.emplace_back(new Parameter("module", types.stringType()));
+	const auto &values = parser_->parseTree(filename);
+	auto current = std::find_if(values.begin(), values.end(),
+		[&src](const UniqPtr<ast::Value> &v)
+		{
+			return src.isInside(v->source());
+		});
 
-	dag::Function::Evaluator import =
-		[&p, &eval, &pluginLoader, srcroot]
-		(dag::ValueMap arguments, dag::DAGBuilder &builder, SourceRange src)
+	if (current == values.end() or not (*current)->name()
+	    or (*current)->name()->name() != valueNames.back())
 	{
-		Bytestream &dbg = Bytestream::Debug("module.import");
+		return;
+	}
 
-		auto n = arguments["module"];
-		SemaCheck(n, src, "missing module or file name");
-		arguments.erase("module");
-		const string name = n->str();
+	std::deque<string> prefix(valueNames.begin(), valueNames.end() - 1);
 
-		auto s = arguments[names::Subdirectory];
-		SemaCheck(s, src, "missing subdir");
-		arguments.erase(names::Subdirectory);
+	// The values that modules can see without being passed arguments:
+	auto scope = eval.CurrentScope();
+	ValueMap reserved;
+	for (const char *name : { names::Fields, names::File, names::Print,
+	                          names::String, names::TypeOf,
+	                          names::Arguments, names::SourceRoot,
+	                          names::BuildRoot })
+	{
+		if (auto v = scope->Lookup(name))
+		{
+			reserved[name] = v;
+		}
+	}
 
-		auto currentSubdir = std::dynamic_pointer_cast<dag::File>(s);
-		SemaCheck(currentSubdir, src, "subdir is not a File");
+	TypeContext &types = eval.types();
 
-		dbg
-			<< Bytestream::Action << "importing "
-			<< Bytestream::Operator << "'"
-			<< Bytestream::Literal << name
-			<< Bytestream::Operator << "'"
-			<< Bytestream::Reset << " from subdir '"
-			<< Bytestream::Literal << *currentSubdir
-			<< Bytestream::Reset << "'...\n"
-			;
+	for (auto i = current + 1; i != values.end(); i++)
+	{
+		const ast::Value &v = **i;
+		auto *call = dynamic_cast<const ast::Call*>(&v.value());
+		if (not v.name() or not call)
+		{
+			continue;
+		}
 
-		const string filename = PathIsAbsolute(name)
-			? name
-			: JoinPath({ srcroot, currentSubdir->str(), name })
-			;
+		auto *target = dynamic_cast<const ast::NameReference*>(&call->target());
+		const ast::Arguments &args = call->arguments();
+		if (not target or target->name().name() != names::Import
+		    or not args.keyword().empty() or args.positional().size() != 1)
+		{
+			continue;
+		}
+
+		const ast::Expression *arg = args.positional().front().get();
+		auto *module = dynamic_cast<const ast::StringLiteral*>(arg);
 
-		if (PathIsFile(filename))
+		if (not module or PathIsAbsolute(module->str()))
 		{
-			const string subdir =
-				JoinPath(currentSubdir->str(), DirectoryOf(name));
+			continue;
+		}
 
-			return ImportFile(filename, subdir, arguments, src, p, eval, dbg);
+		const string directory = JoinPath({ srcroot_, subdir, module->str() });
+		const string fabfile = JoinPath(directory, "fabfile");
+		if (not PathIsDirectory(directory) or not PathIsFile(fabfile))
+		{
+			continue;
 		}
 
-		if (PathIsDirectory(filename))
+		const string moduleSubdir = JoinPath(subdir, module->str());
+		const Key key =
+			std::make_tuple(fabfile, moduleSubdir, dag::Hash(ValueMap()));
+		if (cache_.modules.count(key) or speculations_.count(key))
 		{
-			const string subdir = JoinPath(currentSubdir->str(), name);
-			const string fabfile = JoinPath(filename, "fabfile");
+			continue;
+		}
 
-			SemaCheck(PathIsFile(fabfile), src,
-			          "directory does not contain 'fabfile'");
+		auto spec = std::make_shared<Speculation>();
+		spec->claimed = false;
+		spec->valueNames = prefix;
+		spec->valueNames.push_back(v.name()->name());
+		spec->done = spec->promise.get_future();
+		speculations_.emplace(key, spec);
 
-			return ImportFile(fabfile, subdir, arguments, src, p, eval, dbg);
-		}
+		plugin::Loader &loader = loader_;
+		const string srcroot = srcroot_;
+		const SourceRange callSource = call->source();
 
-		auto descriptor = plugin::Registry::get().lookup(name).lock();
-		if (not descriptor)
+		pool_->Submit([spec, reserved, &types, &loader, srcroot, fabfile,
+		               moduleSubdir, callSource]()
 		{
-			descriptor = pluginLoader.Load(name).lock();
-		}
-		SemaCheck(descriptor, n->source(),
-			"no such file or plugin ('" + name + "')");
+			if (spec->claimed.exchange(true))
+			{
+				// The import is already being evaluated for real.
+				return;
+			}
+
+			Trace::Span span("speculative import", moduleSubdir);
+
+			// Values shared with the importing thread (e.g., srcroot)
+			// must not be modified from here.
+			dag::Owner owner;
+
+			try
+			{
+				spec->eval.reset(
+					new ast::EvalContext(types, spec->valueNames));
+				spec->importer =
+					std::make_shared<Importer>(types, loader, srcroot);
+
+				ast::EvalContext &ctx = *spec->eval;
+				auto scope = ctx.EnterScope("speculative import");
+				for (auto &r : reserved)
+				{
+					scope.DefineReserved(r.first, r.second);
+				}
+				scope.DefineReserved(names::Import,
+					spec->importer->Function(ctx.builder()));
+
+				spec->record = spec->importer->ImportFile(
+					fabfile, moduleSubdir, ValueMap(), callSource,
+					ctx, Bytestream::None());
+			}
+			catch (...)
+			{
+				spec->failure = std::current_exception();
+			}
+
+			spec->promise.set_value();
+		});
+	}
+}
 
-		auto plugin = descriptor->Create(builder, arguments);
-		SemaCheck(plugin, src, "failed to create plugin with arguments");
 
+std::shared_ptr<Record>
+Importer::Speculated(const Key &key, const ValueMap &arguments,
+                     ast::EvalContext &eval, Bytestream &dbg)
+{
+	auto i = speculations_.find(key);
+	if (i == speculations_.end() or not arguments.empty())
+	{
+		return nullptr;
+	}
+
+	auto spec = i->second;
+	speculations_.erase(i);
+
+	// If no worker has started on this module yet, it's ours.
+	if (not spec->claimed.exchange(true))
+	{
+		return nullptr;
+	}
+
+	spec->done.wait();
+
+	string problem;
+	if (spec->failure)
+	{
+		problem = "failed";
+	}
+	else if (spec->valueNames != eval.valueNames())
+	{
+		problem = "was evaluated with the wrong value names";
+	}
+	else
+	{
+		// Modules that we have imported since the speculation started
+		// must be shared, not re-evaluated.
+		for (auto &m : spec->importer->cache_.modules)
+		{
+			if (cache_.modules.count(m.first))
+			{
+				problem = "re-evaluated '" + std::get<0>(m.first) + "'";
+				break;
+			}
+		}
+	}
+
+	if (not problem.empty())
+	{
 		dbg
-			<< Bytestream::Action << "instantiated "
-			<< Bytestream::Type << "plugin"
-			<< Bytestream::Operator << "'"
-			<< Bytestream::Literal << name
-			<< Bytestream::Operator << "': "
-			<< Bytestream::Reset << plugin->type()
-			<< "\n"
+			<< Bytestream::Action << "discarding "
+			<< Bytestream::Type << "speculative import"
+			<< Bytestream::Reset << " of "
+			<< Bytestream::Literal << std::get<1>(key)
+			<< Bytestream::Reset << ": " << problem << "\n"
 			;
 
-		return plugin;
-	};
+		return nullptr;
+	}
 
-	return b.Function(import, types.nilType(), params,
-	                  SourceRange::None(), true);
+	dbg
+		<< Bytestream::Action << "merging "
+		<< Bytestream::Type << "speculative import"
+		<< Bytestream::Reset << " of "
+		<< Bytestream::Literal << std::get<1>(key)
+		<< Bytestream::Reset << "\n"
+		;
+
+	Importer &other = *spec->importer;
+	eval.builder().Merge(std::move(spec->eval->builder()));
+	parser_->Adopt(std::move(*other.parser_));
+	cache_.modules.insert(other.cache_.modules.begin(), other.cache_.modules.end());
+	cache_.selfContained.insert(other.cache_.selfContained.begin(),
+	                            other.cache_.selfContained.end());
+
+	other.cache_.modules.clear();
+	other.delegate_ = shared_from_this();
+
+	return spec->record;
+}
+
+
+ValuePtr
+fabrique::builtins::Import(parsing::Parser &p, plugin::Loader &pluginLoader,
+                           string srcroot, ast::EvalContext &eval, WorkerPool *workers)
+{
+	FAB_ASSERT(PathIsAbsolute(srcroot), "srcroot must be an absolute path");
+
+	auto importer = std::make_shared<Importer>(p, pluginLoader, srcroot, workers);
+	return importer->Function(eval.builder());
 }
 
 
@@ -0,0 +1,87 @@
+//! @file Adjacency.cc    Definition of @ref fabrique::dag::Adjacency
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/AssertionFailure.hh>
+#include <fabrique/dag/Adjacency.hh>
+
+#include <string>
+
+using namespace fabrique::dag;
+using std::vector;
+
+
+const Adjacency::ID Adjacency::None;
+
+
+Adjacency::Adjacency(size_t nodes, const Edges &edges)
+	: offsets_(nodes + 1, 0), edges_(edges.size())
+{
+	FAB_ASSERT(nodes < None and edges.size() < None, "graph too large to index");
+
+	// Count each node's edges, then turn the counts into offsets.
+	for (auto& e : edges)
+	{
+		FAB_ASSERT(e.first < nodes, "edge from invalid node");
+		offsets_[e.first + 1]++;
+	}
+
+	for (size_t n = 0; n < nodes; n++)
+		offsets_[n + 1] += offsets_[n];
+
+	// Place each edge, keeping edges from the same node in their original order.
+	vector<ID> position(offsets_.begin(), offsets_.end() - 1);
+	for (auto& e : edges)
+		edges_[position[e.first]++] = e.second;
+}
+
+
+Adjacency::Range Adjacency::operator[] (ID node) const
+{
+	FAB_ASSERT(static_cast<size_t>(node) + 1 < offsets_.size(),
+	           "invalid node ID " + std::to_string(node));
+
+	const ID *base = edges_.data();
+	return Range(base + offsets_[node], base + offsets_[node + 1]);
+}
+
+
+Adjacency Adjacency::Transpose(size_t nodes) const
+{
+	Edges reversed;
+	reversed.reserve(edges_.size());
+
+	for (ID n = 0; n < this->nodes(); n++)
+	{
+		for (ID e : (*this)[n])
+			reversed.emplace_back(e, n);
+	}
+
+	return Adjacency(nodes, reversed);
+}
@@ -122,26 +122,32 @@ Callable::NameArguments(const vector<string>& args, SourceRange src) const
 {
 	vector<string> namedArgs;
 
-	Bytestream& dbg = Bytestream::Debug("parser.callable");
+	static Bytestream::DebugChannel dbg("parser.callable");
+	if (dbg)
+	{
+		dbg << "matching arguments:\n ";
+		for (auto& a : args)
+			dbg << " " << (a.empty() ? "<unnamed>" : a);
+
+		dbg << "\n to parameters:\n ";
+		for (auto& p : parameters_)
+		{
+			dbg << " "
+				<< Bytestream::Definition << p->name()
+				<< Bytestream::Operator << ":"
+				<< p->type()
+				<< Bytestream::Reset
+				;
+		}
 
-	dbg << "matching arguments:\n ";
-	for (auto& a : args)
-		dbg << " " << (a.empty() ? "<unnamed>" : a);
+		dbg << "\n";
+	}
 
-	dbg << "\n to parameters:\n ";
 	for (auto& p : parameters_)
 	{
 		SemaCheck(p, src, "Callable has null parameter");
-		dbg << " "
-			<< Bytestream::Definition << p->name()
-			<< Bytestream::Operator << ":"
-			<< p->type()
-			<< Bytestream::Reset
-			;
 	}
 
-	dbg << "\n";
-
 	bool doneWithPositionalArgs = false;
 	auto nextParameter = parameters_.begin();
 
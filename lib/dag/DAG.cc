@@ -32,20 +32,27 @@
 
 #include <fabrique/AssertionFailure.hh>
 #include <fabrique/Bytestream.hh>
+#include <fabrique/SemanticException.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/dag/Build.hh>
 #include <fabrique/dag/DAG.hh>
+#include <fabrique/dag/DAGIndex.hh>
 #include <fabrique/dag/File.hh>
 #include <fabrique/dag/Function.hh>
 #include <fabrique/dag/Rule.hh>
 #include <fabrique/dag/TypeReference.hh>
 
 #include <cassert>
+#include <cstdint>
+#include <deque>
 
 using namespace fabrique;
 using namespace fabrique::dag;
 
+using std::pair;
 using std::shared_ptr;
 using std::string;
+using std::vector;
 
 
 void DAG::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
@@ -100,3 +107,129 @@ void DAG::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
 			;
 	}
 }
+
+
+void DAG::Validate() const
+{
+	Trace::Span span("dag", "DAG::Validate");
+
+	using ID = DAGIndex::ID;
+
+	const DAGIndex& index = this->index();
+	const SharedPtrVec<File>& allFiles = files();
+	const SharedPtrVec<Build>& allBuilds = builds();
+
+	//
+	// Each output must be produced by exactly one build.
+	//
+	for (ID f = 0; f < index.fileCount(); f++)
+	{
+		const DAGIndex::Range producers = index.producers(f);
+		if (producers.size() < 2)
+			continue;
+
+		const Build& first = *allBuilds[*producers.begin()];
+		const Build& second = *allBuilds[*(producers.begin() + 1)];
+
+		string detail = "also produced by the build at " + first.source().str();
+		for (auto i = producers.begin() + 2; i != producers.end(); i++)
+			detail += ", " + allBuilds[*i]->source().str();
+
+		throw SemanticException(
+			"'" + allFiles[f]->relativeName()
+				+ "' is produced by more than one build",
+			second.source(), detail);
+	}
+
+	//
+	// Look for cycles with Kahn's algorithm: repeatedly retire builds whose
+	// inputs are all sources or the outputs of already-retired builds.
+	// Anything left over is in (or depends on) a cycle.
+	//
+	vector<size_t> pending(index.buildCount(), 0);
+	std::deque<ID> ready;
+
+	for (ID b = 0; b < index.buildCount(); b++)
+	{
+		for (ID f : index.inputs(b))
+			pending[b] += index.producers(f).size();
+
+		if (pending[b] == 0)
+			ready.push_back(b);
+	}
+
+	size_t retired = 0;
+	while (not ready.empty())
+	{
+		const ID b = ready.front();
+		ready.pop_front();
+		retired++;
+
+		for (ID f : index.outputs(b))
+			for (ID consumer : index.consumers(f))
+				if (--pending[consumer] == 0)
+					ready.push_back(consumer);
+	}
+
+	if (retired == index.buildCount())
+		return;
+
+	//
+	// Walk backwards from an unretired build, always via an input whose
+	// producer is also unretired, until we come back to a build we've seen:
+	// the builds between the two visits form a cycle.
+	//
+	ID b = 0;
+	while (pending[b] == 0)
+		b++;
+
+	vector<size_t> visited(index.buildCount(), SIZE_MAX);
+	vector<pair<ID,ID>> path;    // (build, the input that it's waiting for)
+
+	while (visited[b] == SIZE_MAX)
+	{
+		visited[b] = path.size();
+
+		ID waitingFor = DAGIndex::None;
+		ID producer = DAGIndex::None;
+		for (ID f : index.inputs(b))
+		{
+			for (ID p : index.producers(f))
+			{
+				if (pending[p] > 0)
+				{
+					waitingFor = f;
+					producer = p;
+					break;
+				}
+			}
+
+			if (producer != DAGIndex::None)
+				break;
+		}
+
+		FAB_ASSERT(producer != DAGIndex::None,
+		           "blocked build has no blocked producer");
+
+		path.emplace_back(b, waitingFor);
+		b = producer;
+	}
+
+	// Report the cycle in the order that its builds would run.
+	string cycle;
+	string detail;
+	for (size_t i = path.size(); i > visited[b]; i--)
+	{
+		const Build& build = *allBuilds[path[i - 1].first];
+		const File& input = *allFiles[path[i - 1].second];
+
+		cycle += "'" + input.relativeName() + "' -> ";
+		detail += (detail.empty() ? "" : "; ")
+			+ build.buildRule().name() + " at " + build.source().str();
+	}
+	cycle += "'" + allFiles[path.back().second]->relativeName() + "'";
+
+	throw SemanticException("dependency cycle: " + cycle,
+	                        allBuilds[path.back().first]->source(),
+	                        "builds in cycle: " + detail);
+}
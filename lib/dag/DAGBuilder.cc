@@ -32,12 +32,15 @@
 
 #include <fabrique/AssertionFailure.hh>
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
+#include <fabrique/UserError.hh>
 #include <fabrique/strings.hh>
 
 #include <fabrique/ast/Value.hh>
 
 #include <fabrique/dag/Build.hh>
 #include <fabrique/dag/DAGBuilder.hh>
+#include <fabrique/dag/DAGIndex.hh>
 #include <fabrique/dag/List.hh>
 #include <fabrique/dag/Parameter.hh>
 #include <fabrique/dag/Primitive.hh>
@@ -48,7 +51,9 @@
 #include <fabrique/types/FunctionType.hh>
 #include <fabrique/types/TypeContext.hh>
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_set>
 
 using namespace fabrique;
 using namespace fabrique::dag;
@@ -72,6 +77,7 @@ public:
 		: files_(files), builds_(builds), rules_(rules), vars_(variables),
 		  targets_(targets), topLevelTargets_(topLevelTargets)
 	{
+		index_.reset(new DAGIndex(*this));
 	}
 
 	const SharedPtrVec<File>& files() const override { return files_; }
@@ -88,6 +94,8 @@ public:
 		return topLevelTargets_;
 	}
 
+	const DAGIndex& index() const override { return *index_; }
+
 private:
 	const SharedPtrVec<File> files_;
 	const SharedPtrVec<Build> builds_;
@@ -95,13 +103,145 @@ private:
 	const SharedPtrMap<Value> vars_;
 	const SharedPtrMap<Value> targets_;
 	const vector<BuildTarget> topLevelTargets_;
+	UniqPtr<DAGIndex> index_;
 };
 
+
+/**
+ * Construct the part of a DAG that is required to build some targets:
+ * their files, the builds that (transitively) produce those files and the
+ * rules those builds apply, plus regeneration of the build description.
+ */
+UniqPtr<DAG> Slice(const DAG& dag, const vector<string>& only)
+{
+	Trace::Span span("dag", "Slice");
+
+	using ID = DAGIndex::ID;
+
+	const DAGIndex& index = dag.index();
+	const SharedPtrVec<File>& allFiles = dag.files();
+	const SharedPtrVec<Build>& allBuilds = dag.builds();
+
+	vector<bool> keepFile(index.fileCount(), false);
+	vector<bool> keepBuild(index.buildCount(), false);
+	vector<ID> pending;
+
+	auto keep = [&](ID f)
+	{
+		if (not keepFile[f])
+		{
+			keepFile[f] = true;
+			pending.push_back(f);
+		}
+	};
+
+	std::unordered_set<string> named;
+	for (const string& name : only)
+	{
+		const auto& top = dag.topLevelTargets();
+		const bool isTopLevel = std::any_of(top.begin(), top.end(),
+			[&name](const DAG::BuildTarget& t) { return t.first == name; });
+
+		const ID target = index.target(name);
+		if (not isTopLevel or target == DAGIndex::None)
+		{
+			throw UserError("no such top-level target: '" + name + "'");
+		}
+
+		named.insert(name);
+		for (ID f : index.targetFiles(target))
+			keep(f);
+	}
+
+	// The build description must always be able to regenerate itself.
+	for (ID b = 0; b < index.buildCount(); b++)
+	{
+		if (allBuilds[b]->buildRule().name() == Rule::RegenerationRuleName())
+			for (ID f : index.outputs(b))
+				keep(f);
+	}
+
+	while (not pending.empty())
+	{
+		const ID f = pending.back();
+		pending.pop_back();
+
+		for (ID b : index.producers(f))
+		{
+			if (keepBuild[b])
+				continue;
+
+			keepBuild[b] = true;
+
+			for (ID in : index.inputs(b))
+				keep(in);
+
+			for (ID out : index.outputs(b))
+				keep(out);
+		}
+	}
+
+	SharedPtrVec<File> files;
+	for (ID f = 0; f < index.fileCount(); f++)
+		if (keepFile[f])
+			files.push_back(allFiles[f]);
+
+	SharedPtrVec<Build> builds;
+	std::unordered_set<string> ruleNames;
+	for (ID b = 0; b < index.buildCount(); b++)
+	{
+		if (keepBuild[b])
+		{
+			builds.push_back(allBuilds[b]);
+			ruleNames.insert(allBuilds[b]->buildRule().name());
+		}
+	}
+
+	SharedPtrMap<Rule> rules;
+	for (auto& r : dag.rules())
+		if (ruleNames.find(r.first) != ruleNames.end())
+			rules.insert(r);
+
+	// Keep the named targets and any other targets (e.g., intermediate
+	// libraries) whose files are all within the slice.
+	SharedPtrMap<Value> targets;
+	for (auto& t : dag.targets())
+	{
+		const DAGIndex::Range targetFiles =
+			index.targetFiles(index.target(t.first));
+		const bool inSlice = not targetFiles.empty()
+			and std::all_of(targetFiles.begin(), targetFiles.end(),
+			                [&keepFile](ID f) { return keepFile[f]; });
+
+		if (inSlice or named.find(t.first) != named.end())
+			targets.insert(t);
+	}
+
+	vector<DAG::BuildTarget> top;
+	for (const DAG::BuildTarget& t : dag.topLevelTargets())
+		if (targets.find(t.first) != targets.end())
+			top.push_back(t);
+
+	// Rules are also defined as variables: only keep the ones we use.
+	// Other variables are cheap and any rule or build might refer to them
+	// (e.g., as ${srcroot}), so keep them all.
+	SharedPtrMap<Value> variables;
+	for (auto& v : dag.variables())
+	{
+		auto rule = dynamic_pointer_cast<class Rule>(v.second);
+		if (not rule or ruleNames.find(rule->name()) != ruleNames.end())
+			variables.insert(v);
+	}
+
+	return UniqPtr<DAG>(new ImmutableDAG(files, builds, rules,
+	                                     variables, targets, top));
+}
+
 }
 
 
 DAGBuilder::DAGBuilder(Context& ctx)
-	: ctx_(ctx)
+	: ctx_(ctx), effects_(0), externalEffects_(0), definitionLog_(nullptr)
 {
 }
 
@@ -111,8 +251,56 @@ DAGBuilder::Context::~Context()
 }
 
 
+DAGBuilder::DefinitionRecorder::DefinitionRecorder(DAGBuilder &b)
+	: builder_(b), outer_(b.LogDefinitions(&log_))
+{
+}
+
+DAGBuilder::DefinitionRecorder::~DefinitionRecorder()
+{
+	builder_.LogDefinitions(outer_);
+
+	if (outer_)
+	{
+		outer_->insert(outer_->end(), log_.begin(), log_.end());
+	}
+}
+
+bool DAGBuilder::DefinitionRecorder::Relative(const string &prefix,
+                                              DefinitionLog &out) const
+{
+	const string qualifier = prefix.empty() ? "" : prefix + ".";
+
+	for (auto &d : log_)
+	{
+		if (d.first.compare(0, qualifier.size(), qualifier) != 0)
+		{
+			return false;
+		}
+
+		out.emplace_back(d.first.substr(qualifier.size()), d.second);
+	}
+
+	return true;
+}
+
+
+void DAGBuilder::Define(const string &prefix, const DefinitionLog &definitions)
+{
+	for (auto &d : definitions)
+	{
+		Define(prefix.empty() ? d.first : prefix + "." + d.first, d.second);
+	}
+}
+
+
 void DAGBuilder::Define(string name, ValuePtr v)
 {
+	effects_++;
+
+	if (definitionLog_)
+		definitionLog_->emplace_back(name, v);
+
 	if (v->type().hasFiles())
 		targets_.emplace(name, v);
 	else
@@ -120,25 +308,58 @@ void DAGBuilder::Define(string name, ValuePtr v)
 }
 
 
-UniqPtr<DAG> DAGBuilder::dag(vector<string> topLevelTargets) const
+void DAGBuilder::Merge(DAGBuilder &&other)
+{
+	files_.insert(files_.end(), other.files_.begin(), other.files_.end());
+	builds_.insert(builds_.end(), other.builds_.begin(), other.builds_.end());
+
+	for (auto &i : other.rules_)
+		rules_[i.first] = i.second;
+
+	variables_.insert(other.variables_.begin(), other.variables_.end());
+	targets_.insert(other.targets_.begin(), other.targets_.end());
+	effects_ += other.effects_;
+	externalEffects_ += other.externalEffects_;
+
+	other.files_.clear();
+	other.builds_.clear();
+	other.rules_.clear();
+	other.variables_.clear();
+	other.targets_.clear();
+}
+
+
+UniqPtr<DAG> DAGBuilder::dag(vector<string> topLevelTargets, bool validate,
+                             const vector<string>& only) const
 {
+	Trace::Span span("dag", "DAGBuilder::dag");
+
 	//
-	// Ensure all files are unique.
+	// Ensure all files are unique: files with the same full name share an
+	// interned path ID, so we can de-duplicate them before sorting.
 	//
-	SharedPtrVec<class File> files = files_;
+	SharedPtrVec<class File> files;
+	{
+		std::unordered_set<PathTable::ID> seen;
+		for (auto& f : files_)
+		{
+			if (seen.insert(f->pathID()).second)
+				files.push_back(f);
+		}
+	}
 	std::sort(files.begin(), files.end(), File::LessThan);
-	files.erase(std::unique(files.begin(), files.end(), File::Equals), files.end());
 
 	//
 	// Check for target/filename conflicts.
 	//
+	const std::unordered_set<string> targets(
+		topLevelTargets.begin(), topLevelTargets.end());
+
 	for (auto& file : files)
 	{
 		const string& filename = file->filename();
 
-		const auto& targets = topLevelTargets;
-		auto i = std::find(targets.begin(), targets.end(), filename);
-
+		auto i = targets.find(filename);
 		if (i == targets.end())
 			continue;
 
@@ -173,8 +394,20 @@ UniqPtr<DAG> DAGBuilder::dag(vector<string> topLevelTargets) const
 	}
 
 
-	return UniqPtr<DAG>(
+	UniqPtr<DAG> dag(
 		new ImmutableDAG(files, builds_, rules_, variables_, targets_, top));
+
+	if (validate)
+	{
+		dag->Validate();
+	}
+
+	if (not only.empty())
+	{
+		dag = Slice(*dag, only);
+	}
+
+	return dag;
 }
 
 
@@ -259,6 +492,7 @@ DAGBuilder::Build(shared_ptr<class Rule> rule, ValueMap arguments,
 	shared_ptr<class Build> b(Build::Create(rule, arguments, src));
 
 	builds_.push_back(b);
+	effects_++;
 
 	for (const shared_ptr<class File>& f : b->inputs())
 		files_.push_back(f);
@@ -274,6 +508,7 @@ ValuePtr DAGBuilder::File(string fullPath, ValueMap attributes, SourceRange src,
                           bool generated)
 {
 	const FileType& t = typeContext().fileType();
+	effects_++;
 	files_.emplace_back(File::Create(fullPath, t, attributes, src, generated));
 	return files_.back();
 }
@@ -282,6 +517,7 @@ ValuePtr DAGBuilder::File(string subdir, string name, ValueMap attributes,
                           SourceRange src, bool generated)
 {
 	const FileType& t = typeContext().fileType();
+	effects_++;
 	files_.emplace_back(File::Create(subdir, name, t, attributes, src, generated));
 	return files_.back();
 }
@@ -319,6 +555,7 @@ ValuePtr DAGBuilder::Rule(string name, string command, const Type& type,
 	r->setSelf(r);
 
 	rules_[name] = r;
+	effects_++;
 
 	return r;
 }
@@ -0,0 +1,197 @@
+//! @file DAGIndex.cc    Definition of @ref fabrique::dag::DAGIndex
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/AssertionFailure.hh>
+#include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
+#include <fabrique/dag/Build.hh>
+#include <fabrique/dag/DAG.hh>
+#include <fabrique/dag/DAGIndex.hh>
+#include <fabrique/dag/File.hh>
+#include <fabrique/dag/List.hh>
+#include <fabrique/dag/Rule.hh>
+
+using namespace fabrique;
+using namespace fabrique::dag;
+using std::string;
+using std::vector;
+
+using Edges = Adjacency::Edges;
+
+
+const DAGIndex::ID DAGIndex::None;
+
+
+namespace {
+
+//! Collect the files that a target refers to, the way backends name them.
+void AppendFiles(const Value& v, const DAGIndex& index, DAGIndex::ID target,
+                 Edges &edges)
+{
+	if (auto *f = dynamic_cast<const File*>(&v))
+	{
+		const DAGIndex::ID id = index.file(*f);
+		if (id != DAGIndex::None)
+			edges.emplace_back(target, id);
+	}
+	else if (auto *b = dynamic_cast<const Build*>(&v))
+	{
+		const DAGIndex::ID build = index.build(*b);
+		if (build != DAGIndex::None)
+		{
+			for (DAGIndex::ID id : index.outputs(build))
+				edges.emplace_back(target, id);
+		}
+	}
+	else if (auto *l = dynamic_cast<const List*>(&v))
+	{
+		for (const ValuePtr& element : *l)
+			AppendFiles(*element, index, target, edges);
+	}
+}
+
+} // anonymous namespace
+
+
+DAGIndex::DAGIndex(const DAG& dag)
+{
+	Trace::Span span("dag", "DAGIndex");
+
+	const SharedPtrVec<File>& files = dag.files();
+	const SharedPtrVec<Build>& builds = dag.builds();
+
+	FAB_ASSERT(files.size() < None and builds.size() < None,
+	           "too many nodes to index");
+
+	for (ID i = 0; i < files.size(); i++)
+		fileIDs_.emplace(files[i]->pathID(), i);
+
+	for (ID i = 0; i < builds.size(); i++)
+		buildIDs_.emplace(builds[i].get(), i);
+
+	ID next = 0;
+	for (auto& r : dag.rules())
+		ruleIDs_.emplace(r.first, next++);
+
+	next = 0;
+	for (auto& t : dag.targets())
+		targetIDs_.emplace(t.first, next++);
+
+	Edges in, out, applications;
+	for (ID b = 0; b < builds.size(); b++)
+	{
+		const Build& build = *builds[b];
+
+		for (const std::shared_ptr<File>& f : build.inputs())
+		{
+			const ID id = file(*f);
+			FAB_ASSERT(id != None, "input " + f->fullName() + " not in DAG");
+			in.emplace_back(b, id);
+		}
+
+		for (const std::shared_ptr<File>& f : build.outputs())
+		{
+			const ID id = file(*f);
+			FAB_ASSERT(id != None, "output " + f->fullName() + " not in DAG");
+			out.emplace_back(b, id);
+		}
+
+		const ID r = rule(build.buildRule().name());
+		if (r != None)
+			applications.emplace_back(r, b);
+	}
+
+	inputs_ = Adjacency(builds.size(), in);
+	outputs_ = Adjacency(builds.size(), out);
+	consumers_ = inputs_.Transpose(files.size());
+	producers_ = outputs_.Transpose(files.size());
+	ruleBuilds_ = Adjacency(ruleIDs_.size(), applications);
+
+	Edges targetFiles;
+	next = 0;
+	for (auto& t : dag.targets())
+		AppendFiles(*t.second, *this, next++, targetFiles);
+
+	targetFiles_ = Adjacency(targetIDs_.size(), targetFiles);
+
+	static Bytestream::DebugChannel dbg("dag.index");
+	if (dbg)
+	{
+		dbg
+			<< Bytestream::Action << "indexed"
+			<< Bytestream::Reset << " " << fileCount() << " files, "
+			<< buildCount() << " builds, " << ruleCount() << " rules, "
+			<< targetCount() << " targets and "
+			<< edgeCount() << " edges\n"
+			;
+	}
+}
+
+
+size_t DAGIndex::edgeCount() const
+{
+	return inputs_.size() + outputs_.size() + consumers_.size()
+		+ producers_.size() + ruleBuilds_.size() + targetFiles_.size();
+}
+
+
+DAGIndex::ID DAGIndex::file(const File& f) const
+{
+	auto i = fileIDs_.find(f.pathID());
+	return (i == fileIDs_.end()) ? None : i->second;
+}
+
+
+DAGIndex::ID DAGIndex::build(const Build& b) const
+{
+	auto i = buildIDs_.find(&b);
+	return (i == buildIDs_.end()) ? None : i->second;
+}
+
+
+DAGIndex::ID DAGIndex::rule(const string& name) const
+{
+	auto i = ruleIDs_.find(name);
+	return (i == ruleIDs_.end()) ? None : i->second;
+}
+
+
+DAGIndex::ID DAGIndex::target(const string& name) const
+{
+	auto i = targetIDs_.find(name);
+	return (i == targetIDs_.end()) ? None : i->second;
+}
+
+
+DAGIndex::ID DAGIndex::producer(ID file) const
+{
+	Range p = producers(file);
+	return p.empty() ? None : *p.begin();
+}
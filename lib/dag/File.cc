@@ -87,27 +87,42 @@ File* File::Create(string dir, string path, const FileType& type,
 
 bool File::Equals(const shared_ptr<File>& x, const shared_ptr<File>& y)
 {
-	return (x->fullName() == y->fullName());
+	return (x->fullID_ == y->fullID_);
 }
 
 bool File::LessThan(const shared_ptr<File>& x, const shared_ptr<File>& y)
 {
-	return (x->fullName() < y->fullName());
+	// Interned names are only compared character-by-character if they differ.
+	return (x->fullID_ != y->fullID_ and *x->fullName_ < *y->fullName_);
 }
 
 
 File::File(string filename, string subdirectory, bool absolute,
            const ValueMap& attributes, const FileType& t, SourceRange source,
 	   bool generated)
-	: Value(t, source), filename_(filename), subdirectory_(subdirectory),
-	  absolute_(absolute), generated_(generated), attributes_(attributes)
+	: Value(t, source),
+	  filename_(PathTable::Name(PathTable::Intern(filename))),
+	  subdirectory_(PathTable::Name(PathTable::Intern(subdirectory))),
+	  relativeName_(PathTable::Name(
+		PathTable::Intern(JoinPath(subdirectory, filename)))),
+	  fullName_(nullptr), fullID_(0),
+	  absolute_(absolute), generated_(generated), owner_(Owner::Current()),
+	  attributes_(attributes)
 {
+	InternFullName();
 }
 
 
-string File::filename() const
+void File::InternFullName()
 {
-	return JoinPath(subdirectory_, filename_);
+	fullID_ = PathTable::Intern(JoinPath(directory(), filename_));
+	fullName_ = &PathTable::Name(fullID_);
+}
+
+
+const string& File::filename() const
+{
+	return relativeName_;
 }
 
 
@@ -128,15 +143,15 @@ string File::directory(bool relativeBuildDirectories) const
 }
 
 
-string File::relativeName() const
+const string& File::relativeName() const
 {
-	return JoinPath(subdirectory_, filename_);
+	return relativeName_;
 }
 
 
-string File::fullName() const
+const string& File::fullName() const
 {
-	return JoinPath(directory(), filename_);
+	return *fullName_;
 }
 
 
@@ -145,7 +160,15 @@ void File::setGenerated(bool gen)
 	SemaCheck(not (absolute_ and gen), source(),
 		"cannot generate file with absolute path '" + relativeName() + "'");
 
+	if (gen == generated_)
+		return;
+
+	SemaCheck(Owner::MayModify(owner_), source(),
+		"cannot generate file '" + relativeName()
+		+ "' that was defined outside of this (parallel) evaluation");
+
 	generated_ = gen;
+	InternFullName();
 }
 
 
@@ -0,0 +1,289 @@
+//! @file FileGraph.cc    Definition of @ref fabrique::dag::FileGraph
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/AssertionFailure.hh>
+#include <fabrique/Trace.hh>
+#include <fabrique/UserError.hh>
+#include <fabrique/dag/Build.hh>
+#include <fabrique/dag/DAG.hh>
+#include <fabrique/dag/DAGIndex.hh>
+#include <fabrique/dag/File.hh>
+#include <fabrique/dag/FileGraph.hh>
+
+#include <algorithm>
+#include <deque>
+#include <sstream>
+
+using namespace fabrique;
+using namespace fabrique::dag;
+using std::string;
+using std::vector;
+
+
+const FileGraph::ID FileGraph::None;
+
+
+namespace {
+
+//! Identifies the serialization format: bump when changing the format.
+const char FormatHeader[] = "fabrique-file-graph 1";
+
+vector<string> Names(const DAG& dag)
+{
+	// Files are already sorted by full name (which, for generated files,
+	// is the same as the relative name that backends use).
+	vector<string> names;
+	names.reserve(dag.files().size());
+
+	for (auto& f : dag.files())
+		names.push_back(f->fullName());
+
+	return names;
+}
+
+//! A file depends on the inputs of whichever build(s) produce it.
+Adjacency::Edges Dependencies(const DAG& dag)
+{
+	const DAGIndex& index = dag.index();
+	Adjacency::Edges edges;
+
+	for (DAGIndex::ID b = 0; b < index.buildCount(); b++)
+		for (DAGIndex::ID out : index.outputs(b))
+			for (DAGIndex::ID in : index.inputs(b))
+				edges.emplace_back(out, in);
+
+	return edges;
+}
+
+} // anonymous namespace
+
+
+FileGraph::FileGraph(const DAG& dag)
+	: FileGraph(Names(dag), Dependencies(dag))
+{
+}
+
+
+FileGraph::FileGraph(vector<string> names, const Adjacency::Edges& edges)
+	: names_(std::move(names)), dependencies_(names_.size(), edges),
+	  dependents_(dependencies_.Transpose(names_.size()))
+{
+}
+
+
+FileGraph FileGraph::Parse(const string& serialized)
+{
+	Trace::Span span("query", "FileGraph::Parse");
+
+	std::istringstream in(serialized);
+
+	string header;
+	size_t count = 0;
+	std::getline(in, header);
+	in >> count;
+	in.ignore();
+
+	if (header != FormatHeader or not in.good() or count >= None)
+		throw UserError("malformed file graph");
+
+	vector<string> names(count);
+	for (string& name : names)
+	{
+		if (not std::getline(in, name))
+			throw UserError("malformed file graph: truncated");
+	}
+
+	Adjacency::Edges edges;
+	for (ID from = 0; from < count; from++)
+	{
+		size_t degree = 0;
+		if (not (in >> degree))
+			throw UserError("malformed file graph: truncated");
+
+		for (size_t i = 0; i < degree; i++)
+		{
+			ID to = None;
+			if (not (in >> to) or to >= count)
+				throw UserError("malformed file graph: invalid file ID");
+
+			edges.emplace_back(from, to);
+		}
+	}
+
+	return FileGraph(std::move(names), edges);
+}
+
+
+string FileGraph::Serialize() const
+{
+	std::ostringstream out;
+
+	out << FormatHeader << "\n" << names_.size() << "\n";
+
+	for (const string& name : names_)
+		out << name << "\n";
+
+	for (ID n = 0; n < names_.size(); n++)
+	{
+		const Adjacency::Range deps = dependencies_[n];
+
+		out << deps.size();
+		for (ID d : deps)
+			out << " " << d;
+		out << "\n";
+	}
+
+	return out.str();
+}
+
+
+FileGraph::ID FileGraph::find(const string& name) const
+{
+	for (const string& candidate : { name, "${srcroot}/" + name })
+	{
+		auto i = std::lower_bound(names_.begin(), names_.end(), candidate);
+		if (i != names_.end() and *i == candidate)
+			return static_cast<ID>(i - names_.begin());
+	}
+
+	return None;
+}
+
+
+vector<FileGraph::ID> FileGraph::deps(ID file) const
+{
+	const vector<bool> reachable = Reachable(dependencies_, file);
+
+	vector<ID> result;
+	for (ID n = 0; n < reachable.size(); n++)
+		if (reachable[n])
+			result.push_back(n);
+
+	return result;
+}
+
+
+vector<FileGraph::ID> FileGraph::rdeps(ID file) const
+{
+	const vector<bool> reachable = Reachable(dependents_, file);
+
+	vector<ID> result;
+	for (ID n = 0; n < reachable.size(); n++)
+		if (reachable[n])
+			result.push_back(n);
+
+	return result;
+}
+
+
+vector<FileGraph::ID> FileGraph::somepath(ID from, ID to) const
+{
+	if (from == to)
+		return { from };
+
+	// Breadth-first search, so the path we find is a shortest one.
+	vector<ID> parent(names_.size(), None);
+	std::deque<ID> queue { from };
+	parent[from] = from;
+
+	while (not queue.empty() and parent[to] == None)
+	{
+		const ID n = queue.front();
+		queue.pop_front();
+
+		for (ID d : dependencies_[n])
+		{
+			if (parent[d] == None)
+			{
+				parent[d] = n;
+				queue.push_back(d);
+			}
+		}
+	}
+
+	vector<ID> path;
+	if (parent[to] == None)
+		return path;
+
+	for (ID n = to; n != from; n = parent[n])
+		path.push_back(n);
+	path.push_back(from);
+
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+
+vector<FileGraph::ID> FileGraph::allpaths(ID from, ID to) const
+{
+	// A file is on a path from -> to iff it is reachable from 'from'
+	// and 'to' is reachable from it.
+	vector<bool> forward = Reachable(dependencies_, from);
+	vector<bool> backward = Reachable(dependents_, to);
+	forward[from] = true;
+	backward[to] = true;
+
+	vector<ID> result;
+	if (not forward[to])
+		return result;
+
+	for (ID n = 0; n < names_.size(); n++)
+		if (forward[n] and backward[n])
+			result.push_back(n);
+
+	return result;
+}
+
+
+vector<bool> FileGraph::Reachable(const Adjacency& edges, ID start)
+{
+	FAB_ASSERT(start < edges.nodes(), "invalid file ID");
+
+	vector<bool> seen(edges.nodes(), false);
+	vector<ID> stack { start };
+
+	while (not stack.empty())
+	{
+		const ID n = stack.back();
+		stack.pop_back();
+
+		for (ID next : edges[n])
+		{
+			if (not seen[next])
+			{
+				seen[next] = true;
+				stack.push_back(next);
+			}
+		}
+	}
+
+	seen[start] = false;
+	return seen;
+}
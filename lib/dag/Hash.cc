@@ -0,0 +1,295 @@
+//! @file dag/Hash.cc    Structural hashing of @ref fabrique::dag::Value objects
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/hash.hh>
+#include <fabrique/dag/Build.hh>
+#include <fabrique/dag/File.hh>
+#include <fabrique/dag/Function.hh>
+#include <fabrique/dag/Hash.hh>
+#include <fabrique/dag/List.hh>
+#include <fabrique/dag/Primitive.hh>
+#include <fabrique/dag/Record.hh>
+#include <fabrique/dag/Rule.hh>
+#include <fabrique/dag/TypeReference.hh>
+#include <fabrique/dag/Visitor.hh>
+#include <fabrique/types/RecordShape.hh>
+#include <fabrique/types/Type.hh>
+
+using namespace fabrique;
+using namespace fabrique::dag;
+using std::string;
+
+
+namespace {
+
+//! Distinguishes values of different kinds that have similar contents.
+enum class Kind : uint64_t
+{
+	Boolean = 1, Build, File, Function, Integer, List, Record, Rule,
+	String, TypeReference,
+};
+
+class Hasher : public Visitor
+{
+public:
+	uint64_t hash(const Value &v)
+	{
+		v.Accept(*this);
+		return hash_;
+	}
+
+	bool Visit(const Boolean &b) override
+	{
+		return Mix(Kind::Boolean, b.value());
+	}
+
+	bool Visit(const Build &b) override
+	{
+		return Mix(Kind::Build, reinterpret_cast<uintptr_t>(&b));
+	}
+
+	bool Visit(const File &f) override
+	{
+		Mix(Kind::File, f.generated());
+		hash_ = HashBytes(f.fullName(), hash_);
+		hash_ = HashCombine(hash_, Hash(f.attributes()));
+		return false;
+	}
+
+	bool Visit(const Function &f) override
+	{
+		return Mix(Kind::Function, reinterpret_cast<uintptr_t>(&f));
+	}
+
+	bool Visit(const Integer &i) override
+	{
+		return Mix(Kind::Integer, static_cast<uint64_t>(i.value()));
+	}
+
+	bool Visit(const List &l) override
+	{
+		Mix(Kind::List, l.size());
+		for (auto &e : l)
+		{
+			hash_ = HashCombine(hash_, Hash(*e));
+		}
+		return false;
+	}
+
+	bool Visit(const Record &r) override
+	{
+		Mix(Kind::Record, 0);
+
+		// Hash fields the same way as an (ordered) ValueMap would be.
+		const RecordShape &shape = r.shape();
+		uint64_t fields = HashCombine(0, shape.size());
+		for (size_t i = 0; i < shape.size(); i++)
+		{
+			const ValuePtr &v = r.fieldAt(i);
+			fields = HashBytes(shape.name(i), fields);
+			fields = HashCombine(fields, v ? Hash(*v) : 0);
+		}
+
+		hash_ = HashCombine(hash_, fields);
+		return false;
+	}
+
+	bool Visit(const Rule &r) override
+	{
+		return Mix(Kind::Rule, reinterpret_cast<uintptr_t>(&r));
+	}
+
+	bool Visit(const String &s) override
+	{
+		Mix(Kind::String, 0);
+		hash_ = HashBytes(s.value(), hash_);
+		return false;
+	}
+
+	bool Visit(const TypeReference &t) override
+	{
+		Mix(Kind::TypeReference, 0);
+		hash_ = HashBytes(t.referencedType().str(), hash_);
+		return false;
+	}
+
+private:
+	bool Mix(Kind k, uint64_t value)
+	{
+		hash_ = HashCombine(HashCombine(hash_, static_cast<uint64_t>(k)), value);
+		return false;
+	}
+
+	uint64_t hash_ = 0;
+};
+
+} // anonymous namespace
+
+
+uint64_t dag::Hash(const Value &v)
+{
+	return Hasher().hash(v);
+}
+
+uint64_t dag::Hash(const ValueMap &values)
+{
+	// ValueMap is ordered, so equivalent maps hash their entries in the same order.
+	uint64_t hash = HashCombine(0, values.size());
+	for (auto &i : values)
+	{
+		hash = HashBytes(i.first, hash);
+		hash = HashCombine(hash, i.second ? Hash(*i.second) : 0);
+	}
+
+	return hash;
+}
+
+
+bool dag::Equivalent(const Value &x, const Value &y)
+{
+	if (&x == &y)
+	{
+		return true;
+	}
+
+	// Most types are only created once, but e.g. record types can be repeated.
+	if (&x.type() != &y.type() and x.type().str() != y.type().str())
+	{
+		return false;
+	}
+
+	if (auto *b = dynamic_cast<const Boolean*>(&x))
+	{
+		auto *other = dynamic_cast<const Boolean*>(&y);
+		return other and b->value() == other->value();
+	}
+
+	if (auto *i = dynamic_cast<const Integer*>(&x))
+	{
+		auto *other = dynamic_cast<const Integer*>(&y);
+		return other and i->value() == other->value();
+	}
+
+	if (auto *s = dynamic_cast<const String*>(&x))
+	{
+		auto *other = dynamic_cast<const String*>(&y);
+		return other and s->value() == other->value();
+	}
+
+	if (auto *f = dynamic_cast<const File*>(&x))
+	{
+		auto *g = dynamic_cast<const File*>(&y);
+		return g
+			and f->pathID() == g->pathID()
+			and f->generated() == g->generated()
+			and Equivalent(f->attributes(), g->attributes());
+	}
+
+	if (auto *l = dynamic_cast<const List*>(&x))
+	{
+		auto *m = y.asList();
+		if (not m or l->size() != m->size())
+		{
+			return false;
+		}
+
+		auto j = m->begin();
+		for (auto &e : *l)
+		{
+			if (not Equivalent(*e, **j++))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	if (auto *r = dynamic_cast<const Record*>(&x))
+	{
+		auto *other = dynamic_cast<const Record*>(&y);
+		// Shapes are interned: records with the same fields share one.
+		if (not other or &other->shape() != &r->shape())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < r->shape().size(); i++)
+		{
+			const ValuePtr &a = r->fieldAt(i), &b = other->fieldAt(i);
+			if (a != b and (not a or not b or not Equivalent(*a, *b)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	if (auto *t = dynamic_cast<const TypeReference*>(&x))
+	{
+		auto *other = dynamic_cast<const TypeReference*>(&y);
+		return other
+			and t->referencedType().str() == other->referencedType().str();
+	}
+
+	// Builds, functions and rules are only equivalent to themselves.
+	return false;
+}
+
+bool dag::Equivalent(const ValueMap &x, const ValueMap &y)
+{
+	if (x.size() != y.size())
+	{
+		return false;
+	}
+
+	for (auto i = x.begin(), j = y.begin(); i != x.end(); i++, j++)
+	{
+		if (i->first != j->first)
+		{
+			return false;
+		}
+
+		if (not i->second or not j->second)
+		{
+			if (i->second != j->second)
+			{
+				return false;
+			}
+		}
+		else if (not Equivalent(*i->second, *j->second))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -54,6 +54,8 @@ List* List::of(const SharedPtrVec<Value>& values, const SourceRange& src,
 	const Type *elementType = nullptr;
 	for (auto &v : values)
 	{
+		SemaCheck(v, src, "passed null value to List");
+
 		if (elementType)
 		{
 			elementType = &elementType->supertype(v->type());
@@ -64,31 +66,29 @@ List* List::of(const SharedPtrVec<Value>& values, const SourceRange& src,
 		}
 	}
 
+	auto storage = std::make_shared<Storage>();
+	storage->values.assign(values.begin(), values.end());
+
 	const Type &t = values.empty() ? ctx.emptyList() : Type::ListOf(*elementType);
-	return new List(values, t, src);
+	return new List(storage, storage->begin(), storage->end(), t, src);
 }
 
 
-List::List(const SharedPtrVec<Value>& v, const Type& t, const SourceRange& src)
-	: Value(t, src), elements_(v)
+List::List(shared_ptr<Storage> storage, ptrdiff_t begin, ptrdiff_t end,
+           const Type& t, const SourceRange& src)
+	: Value(t, src), storage_(std::move(storage)), begin_(begin), end_(end)
 {
-#ifndef NDEBUG
-	for (auto& value : v)
-	{
-		SemaCheck(value, src, "passed null value to List");
-	}
-#endif
 }
 
 
-List::iterator List::begin() const { return elements_.begin(); }
-List::iterator List::end() const { return elements_.end(); }
+List::iterator List::begin() const { return iterator(*storage_, begin_); }
+List::iterator List::end() const { return iterator(*storage_, end_); }
 
-size_t List::size() const { return elements_.size(); }
+size_t List::size() const { return static_cast<size_t>(end_ - begin_); }
 
 const Value& List::operator [] (size_t i) const
 {
-	return *elements_[i];
+	return *(*storage_)[begin_ + static_cast<ptrdiff_t>(i)];
 }
 
 
@@ -99,11 +99,45 @@ ValuePtr List::Add(ValuePtr& n, SourceRange src) const
 	const List *next = n->asList();
 	SemaCheck(next, loc, "lists can only be concatenated with lists");
 
-	SharedPtrVec<Value> values(elements_);
-	auto& nextElem = next->elements_;
-	values.insert(values.end(), nextElem.begin(), nextElem.end());
+	//
+	// The element type of the concatenation is the supertype of the two
+	// lists' (already-computed) element types.
+	//
+	TypeContext &ctx = type().context();
+	const Type &t =
+		next->size() == 0 ? type()
+		: size() == 0 ? next->type()
+		: ctx.listOf(elementType().supertype(next->elementType()));
 
-	return ValuePtr(List::of(values, loc, type().context()));
+	//
+	// If nothing follows us in our storage, we can append the other list's
+	// elements to it. Similarly, if nothing precedes the other list, we can
+	// prepend our elements to its storage.
+	//
+	const bool shared = (storage_ == next->storage_);
+
+	if (end_ == storage_->end() and not shared and storage_->extensible())
+	{
+		auto &values = storage_->values;
+		values.insert(values.end(), next->begin(), next->end());
+		return ValuePtr(new List(storage_, begin_, storage_->end(), t, loc));
+	}
+
+	if (next->begin_ == next->storage_->begin() and not shared
+	    and next->storage_->extensible())
+	{
+		Storage &s = *next->storage_;
+		s.values.insert(s.values.begin(), begin(), end());
+		s.origin += end_ - begin_;
+
+		return ValuePtr(new List(next->storage_, s.begin(), next->end_, t, loc));
+	}
+
+	auto storage = std::make_shared<Storage>();
+	storage->values.insert(storage->values.end(), begin(), end());
+	storage->values.insert(storage->values.end(), next->begin(), next->end());
+
+	return ValuePtr(new List(storage, storage->begin(), storage->end(), t, loc));
 }
 
 ValuePtr List::PrefixWith(ValuePtr& prefix, SourceRange src) const
@@ -119,16 +153,24 @@ ValuePtr List::PrefixWith(ValuePtr& prefix, SourceRange src) const
 	// ```
 	//
 	const Type &pt = prefix->type();
-	const Type &elementTy = elements_.empty() ? pt : pt.supertype(type()[0]);
+	const Type &elementTy = size() == 0 ? pt : pt.supertype(elementType());
 	const Type &t = type().context().listOf(elementTy);
+	const SourceRange loc = src ? src : SourceRange::Over(prefix.get(), this);
+
+	// If nothing precedes us in our storage, we can extend it in place.
+	if (begin_ == storage_->begin() and storage_->extensible())
+	{
+		storage_->values.push_front(prefix);
+		storage_->origin++;
+
+		return ValuePtr(new List(storage_, storage_->begin(), end_, t, loc));
+	}
 
-	SharedPtrVec<Value> values;
-	values.push_back(prefix);
-	values.insert(values.end(), elements_.begin(), elements_.end());
+	auto storage = std::make_shared<Storage>();
+	storage->values.push_back(prefix);
+	storage->values.insert(storage->values.end(), begin(), end());
 
-	return ValuePtr(
-		new List(values, t, src ? src : SourceRange::Over(prefix.get(), this))
-	);
+	return ValuePtr(new List(storage, storage->begin(), storage->end(), t, loc));
 }
 
 bool List::canScalarAdd(const Value& other) const
@@ -150,7 +192,7 @@ void List::PrettyPrint(Bytestream& out, unsigned int indent) const
 		<< Bytestream::Reset
 		;
 
-	for (const ValuePtr& p : elements_)
+	for (const ValuePtr& p : *this)
 	{
 		p->PrettyPrint(out, indent);
 		out << " ";
@@ -167,7 +209,7 @@ void List::Accept(Visitor& v) const
 {
 	if (v.Visit(*this))
 	{
-		for (auto& e : elements_)
+		for (auto& e : *this)
 			e->Accept(v);
 	}
 }
@@ -41,6 +41,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <vector>
 
 using namespace fabrique::dag;
 using std::dynamic_pointer_cast;
@@ -184,11 +185,68 @@ void Integer::Accept(Visitor& v) const
 
 
 String::String(string s, const Type& t, SourceRange loc)
-	: Primitive(t, s, loc)
+	: Value(t, loc), length_(s.length()), value_(std::move(s)), flat_(true)
 {
 }
 
-string String::str() const { return value_; }
+String::String(Ptr left, Ptr right, const Type& t, SourceRange loc)
+	: Value(t, loc), length_(left->length_ + right->length_),
+	  left_(std::move(left)), right_(std::move(right)), flat_(false)
+{
+}
+
+ValuePtr String::Concatenate(Ptr left, Ptr right, const Type &t, SourceRange src)
+{
+	// Below this length, copying is cheaper than keeping track of operands.
+	static const size_t ShortString = 64;
+
+	if (left->length_ + right->length_ <= ShortString)
+	{
+		return ValuePtr(new String(left->value() + right->value(), t, src));
+	}
+
+	return ValuePtr(new String(std::move(left), std::move(right), t, src));
+}
+
+const string& String::value() const
+{
+	if (not flat_.load(std::memory_order_acquire))
+	{
+		std::call_once(flattening_, [this]()
+		{
+			string s;
+			s.reserve(length_);
+			AppendTo(s);
+
+			value_ = std::move(s);
+			flat_.store(true, std::memory_order_release);
+		});
+	}
+
+	return value_;
+}
+
+void String::AppendTo(string &s) const
+{
+	// Concatenations can be deeply nested, so don't recurse.
+	std::vector<const String*> pending = { this };
+
+	while (not pending.empty())
+	{
+		const String *next = pending.back();
+		pending.pop_back();
+
+		if (next->flat_.load(std::memory_order_acquire))
+		{
+			s += next->value_;
+		}
+		else
+		{
+			pending.push_back(next->right_.get());
+			pending.push_back(next->left_.get());
+		}
+	}
+}
 
 ValuePtr String::Add(ValuePtr& v, SourceRange src) const
 {
@@ -197,8 +255,7 @@ ValuePtr String::Add(ValuePtr& v, SourceRange src) const
 	shared_ptr<String> other = std::dynamic_pointer_cast<String>(v);
 	SemaCheck(other, src, "cannot add string with " + v->type().str());
 
-	return ValuePtr(
-		new String(this->value_ + other->value_, type(), loc));
+	return Concatenate(shared_from_this(), other, type(), loc);
 }
 
 ValuePtr String::PrefixWith(ValuePtr &v, SourceRange src) const
@@ -210,14 +267,14 @@ ValuePtr String::PrefixWith(ValuePtr &v, SourceRange src) const
 		const auto *t = dynamic_cast<const FileType*>(&f->type());
 		SemaCheck(t, f->source(), "not a file");
 
-		const string name = platform::JoinPath(f->filename(), value_);
+		const string name = platform::JoinPath(f->filename(), value());
 		const bool generated = f->generated();
 
 		return ValuePtr(File::Create(name, *t, f->attributes(), src, generated));
 	}
 	else if (auto s = dynamic_pointer_cast<String>(v))
 	{
-		return ValuePtr(new String(s->value_ + this->value_, type(), src));
+		return Concatenate(s, shared_from_this(), type(), src);
 	}
 
 	throw SemanticException("cannot prefix string with " + v->type().str(), src);
@@ -231,11 +288,11 @@ ValuePtr String::Equals(ValuePtr& v, SourceRange src) const
 	SemaCheck(other, loc, "cannot check string equality with " + v->type().str());
 
 	// Don't trust std::string::compare, it thinks "foo" != "foo\0".
-	const char *x = this->value_.data();
+	const char *x = this->value().data();
 	const size_t len = strnlen(x, MaxStringLength);
 	SemaCheck(len < MaxStringLength, source(), "string too long");
 
-	const char *y = other->value_.data();
+	const char *y = other->value().data();
 	const bool equal = (strncmp(x, y, len) == 0);
 
 	return ValuePtr(
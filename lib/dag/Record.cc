@@ -29,9 +29,11 @@
  * SUCH DAMAGE.
  */
 
+#include <fabrique/AssertionFailure.hh>
 #include <fabrique/Bytestream.hh>
 #include <fabrique/dag/Record.hh>
 #include <fabrique/dag/Visitor.hh>
+#include <fabrique/types/RecordShape.hh>
 #include <fabrique/types/RecordType.hh>
 #include <fabrique/types/TypeContext.hh>
 
@@ -50,34 +52,45 @@ Record* Record::Create(const ValueMap& fields, TypeContext& types, SourceRange s
 	}
 
 	RecordType::NamedTypeVec fieldTypes;
+	vector<ValuePtr> values;
 	for (const auto& field : fields)
 	{
 		fieldTypes.emplace_back(field.first, field.second->type());
+		values.push_back(field.second);
 	}
 
+	// Fields are laid out in the (name) order of the map.
 	const RecordType& t = types.recordType(fieldTypes);
-	return new Record(fields, t, src);
+	return new Record(values, t, src);
 }
 
 
-Record::Record(const ValueMap& fields, const Type& t, SourceRange src)
-	: Value(t, src), fields_(fields)
+Record::Record(const vector<ValuePtr>& values, const RecordType& t, SourceRange src)
+	: Value(t, src), shape_(t.shape()), values_(values)
 {
+	FAB_ASSERT(shape_.size() == values_.size(), "record doesn't match its shape");
 }
 
 
 Record::~Record() {}
 
 
-ValuePtr Record::field(const std::string& name) const
+ValueMap Record::fields() const
 {
-	for (auto& i : fields_)
+	ValueMap fields;
+	for (size_t i = 0; i < values_.size(); i++)
 	{
-		if (i.first == name)
-			return i.second;
+		fields.emplace(shape_.name(i), values_[i]);
 	}
 
-	return ValuePtr();
+	return fields;
+}
+
+
+ValuePtr Record::field(const std::string& name) const
+{
+	const size_t i = shape_.offset(name);
+	return (i == RecordShape::NoField) ? ValuePtr() : values_[i];
 }
 
 
@@ -89,17 +102,17 @@ void Record::PrettyPrint(Bytestream& out, unsigned int indent) const
 	out << Bytestream::Operator << "{\n"
 		;
 
-	for (auto& i : fields_)
+	for (size_t i = 0; i < values_.size(); i++)
 	{
 		out
 			<< innerTab
-			<< Bytestream::Definition << i.first
+			<< Bytestream::Definition << shape_.name(i)
 			<< Bytestream::Operator << ":"
-			<< Bytestream::Reset << i.second->type()
+			<< Bytestream::Reset << values_[i]->type()
 			<< Bytestream::Operator << " = "
 			;
 
-		i.second->PrettyPrint(out, indent + 1);
+		values_[i]->PrettyPrint(out, indent + 1);
 
 		out
 			<< Bytestream::Reset << "\n"
@@ -116,6 +129,6 @@ void Record::PrettyPrint(Bytestream& out, unsigned int indent) const
 void Record::Accept(Visitor& v) const
 {
 	if (v.Visit(*this))
-		for (auto& i : fields_)
-			i.second->Accept(v);
+		for (auto& value : values_)
+			value->Accept(v);
 }
@@ -0,0 +1,90 @@
+//! @file  hash.cc    Definitions of stable hash functions
+/*
+ * Copyright (c) 2019 Jonathan Anderson
+ * All rights reserved.
+ *
+ * This software was developed at Memorial University of Newfoundland
+ * under the NSERC Discovery program (RGPIN-2015-06048).
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <fabrique/hash.hh>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace fabrique;
+using std::string;
+
+namespace {
+const uint64_t FNVPrime = 0x100000001b3;
+}
+
+
+uint64_t fabrique::HashBytes(const string &bytes, uint64_t hash)
+{
+	for (const char c : bytes)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= FNVPrime;
+	}
+
+	// Also hash the length so that ("ab", "c") and ("a", "bc") differ:
+	return HashCombine(hash, bytes.length());
+}
+
+
+uint64_t fabrique::HashCombine(uint64_t x, uint64_t y)
+{
+	for (unsigned int i = 0; i < sizeof(y); i++)
+	{
+		x ^= (y >> (8 * i)) & 0xff;
+		x *= FNVPrime;
+	}
+
+	return x;
+}
+
+
+uint64_t fabrique::HashFile(const string &filename)
+{
+	std::ifstream f(filename, std::ios::binary);
+	if (not f.good())
+	{
+		return HashBytes("<unreadable file: " + filename + ">");
+	}
+
+	std::ostringstream contents;
+	contents << f.rdbuf();
+
+	return HashBytes(contents.str());
+}
+
+
+string fabrique::HashString(uint64_t hash)
+{
+	std::ostringstream oss;
+	oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return oss.str();
+}
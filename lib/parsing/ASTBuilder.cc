@@ -46,7 +46,7 @@ using std::string;
 ASTBuilder::ASTBuilder(std::string filename)
 	: debug_(Bytestream::Debug("ast.parser")),
 	  fullDebug_(Bytestream::Debug("ast.parser.detail")),
-	  filename_(std::move(filename))
+	  file_(SourceFiles::Intern(filename))
 {
 }
 
@@ -559,10 +559,10 @@ SourceRange ASTBuilder::source(antlr4::tree::TerminalNode &node)
 
 SourceRange ASTBuilder::source(const antlr4::ParserRuleContext &ctx)
 {
-	SourceLocation begin(filename_, ctx.start->getLine(),
+	SourceLocation begin(file_, ctx.start->getLine(),
 	                     ctx.start->getCharPositionInLine() + 1);
 
-	SourceLocation end(filename_, ctx.stop->getLine(),
+	SourceLocation end(file_, ctx.stop->getLine(),
 	                   ctx.stop->getCharPositionInLine() + ctx.stop->getText().length() + 1);
 
 	return SourceRange(begin, end);
@@ -574,8 +574,8 @@ SourceRange ASTBuilder::source(const antlr4::Token &t)
 	size_t col = t.getCharPositionInLine() + 1;
 	size_t length = t.getText().length();    // TODO: a better way?
 
-	SourceLocation begin(filename_, line, col);
-	SourceLocation end(filename_, line, col + length);
+	SourceLocation begin(file_, line, col);
+	SourceLocation end(file_, line, col + length);
 
 	return SourceRange(begin, end);
 }
@@ -31,8 +31,12 @@
  */
 
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/UserError.hh>
 #include <fabrique/ast/ASTDump.hh>
+#include <fabrique/ast/Optimizer.hh>
+#include <fabrique/ast/Resolver.hh>
+#include <fabrique/ast/TypeChecker.hh>
 #include <fabrique/parsing/ASTBuilder.hh>
 #include <fabrique/parsing/ErrorListener.hh>
 #include <fabrique/parsing/Parser.hh>
@@ -47,6 +51,7 @@
 
 #include <cassert>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 
 using namespace fabrique;
@@ -56,6 +61,16 @@ using std::string;
 using std::unique_ptr;
 
 
+/**
+ * The ANTLR runtime shares its DFA cache among all instances of a parser,
+ * so parsers on different threads must not run at the same time.
+ */
+static std::mutex& antlrLock()
+{
+	static std::mutex& lock = *new std::mutex;
+	return lock;
+}
+
 //! Internal ANTLR state
 struct ParserState
 {
@@ -126,8 +141,8 @@ struct ParserState
 };
 
 
-Parser::Parser(bool prettyPrint, bool dump)
-	: prettyPrint_(prettyPrint), dump_(dump)
+Parser::Parser(TypeContext &types, bool prettyPrint, bool dump)
+	: types_(types), prettyPrint_(prettyPrint), dump_(dump)
 {
 }
 
@@ -144,6 +159,7 @@ Parser::ValueResult Parser::Parse(std::string s, SourceRange src)
 		<< Bytestream::Reset << "\n"
 		;
 
+	std::lock_guard<std::mutex> lock(antlrLock());
 	ParserState state(s, src.filename(), prettyPrint_, dump_);
 	bool success = false;
 	try
@@ -184,6 +200,8 @@ Parser::FileResult Parser::ParseFile(std::istream& input, string name)
 		return FileResult::Ok(existing->second);
 	}
 
+	Trace::Span span("parse", name);
+
 	Bytestream& dbg = Bytestream::Debug("parser.file");
 	dbg
 		<< Bytestream::Action << "Parsing"
@@ -194,26 +212,39 @@ Parser::FileResult Parser::ParseFile(std::istream& input, string name)
 		<< Bytestream::Reset << "\n"
 		;
 
-	ParserState state(input, name, prettyPrint_, dump_);
-	bool success = false;
-	try
+	UniqPtrVec<ast::Value> parsed;
 	{
-		success = state.ast.visitFile(state.parser.file());
-	}
-	catch (...)
-	{
-		FAB_ASSERT(not state.errors().empty(), "parsing failed without error");
-	}
+		std::lock_guard<std::mutex> lock(antlrLock());
+		ParserState state(input, name, prettyPrint_, dump_);
+		bool success = false;
+		try
+		{
+			success = state.ast.visitFile(state.parser.file());
+		}
+		catch (...)
+		{
+			FAB_ASSERT(not state.errors().empty(),
+			           "parsing failed without error");
+		}
 
-	if (not success)
-	{
-		return FileResult::Err(state.errors());
+		if (not success)
+		{
+			return FileResult::Err(state.errors());
+		}
+
+		parsed = state.ast.takeValues();
 	}
 
-	inputs_.push_back(name);
-	auto i = parseTrees_.emplace(name, state.ast.takeValues());
-	FAB_ASSERT(i.second, "failed to emplace in parseTrees_");
-	const auto &values = i.first->second;
+	// Neither the tree nor its name (in inputs_) is kept until the tree has
+	// passed all of the checks below: a later request for the same file
+	// mustn't get an unchecked tree, and Adopt() expects a tree per input.
+	const auto &values = parsed;
+
+	// Resolve names to lexical addresses once, rather than on every lookup.
+	ast::Resolver().Resolve(values);
+
+	// Check types statically, so that evaluation can skip proven checks.
+	ast::TypeChecker(types_).Check(values);
 
 	if (prettyPrint_)
 	{
@@ -240,7 +271,18 @@ Parser::FileResult Parser::ParseFile(std::istream& input, string name)
 		}
 	}
 
-	return FileResult::Ok(values);
+	// Simplify what we can before evaluation (but after printing the AST,
+	// which should reflect what was actually written).
+	{
+		Trace::Span optimizeSpan("optimize", name);
+		ast::Optimizer().AddStandardPasses(types_).Optimize(values);
+	}
+
+	auto i = parseTrees_.emplace(name, std::move(parsed));
+	FAB_ASSERT(i.second, "failed to emplace in parseTrees_");
+	inputs_.push_back(name);
+
+	return FileResult::Ok(i.first->second);
 }
 
 
@@ -260,3 +302,38 @@ const UniqPtrVec<ast::Value>& Parser::parseTree(const std::string &name)
 
 	return i->second;
 }
+
+
+bool Parser::hasParseTree(const std::string &name) const
+{
+	return parseTrees_.find(name) != parseTrees_.end();
+}
+
+
+void Parser::Adopt(Parser &&other)
+{
+	for (const string &name : other.inputs_)
+	{
+		auto i = other.parseTrees_.find(name);
+		FAB_ASSERT(i != other.parseTrees_.end(), "no tree for '" + name + "'");
+
+		if (hasParseTree(name))
+		{
+			retained_.push_back(std::move(i->second));
+		}
+		else
+		{
+			parseTrees_.emplace(name, std::move(i->second));
+			inputs_.push_back(name);
+		}
+	}
+
+	for (auto &tree : other.retained_)
+	{
+		retained_.push_back(std::move(tree));
+	}
+
+	other.inputs_.clear();
+	other.parseTrees_.clear();
+	other.retained_.clear();
+}
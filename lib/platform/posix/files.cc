@@ -38,11 +38,15 @@
 #include <fabrique/platform/PosixError.hh>
 #include <fabrique/platform/files.hh>
 
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 
 #include <sys/stat.h>
 
+#include <fcntl.h>
 #include <libgen.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -312,5 +316,89 @@ bool PathIsFile(string path)
 	return FileExists(path, false);
 }
 
+
+bool WriteFileIfChanged(const string& filename, const string& contents)
+{
+	struct stat s;
+	const bool exists = (stat(filename.c_str(), &s) == 0 and S_ISREG(s.st_mode));
+
+	if (exists and static_cast<size_t>(s.st_size) == contents.size())
+	{
+		std::ifstream existing(filename, std::ios::binary);
+		string current(contents.size(), '\0');
+
+		const auto size = static_cast<std::streamsize>(current.size());
+		if (existing.read(&current[0], size) and current == contents)
+		{
+			return false;
+		}
+	}
+
+	//
+	// Write to a temporary file in the same directory (so that rename(2)
+	// is atomic) whose name is unique to this process and call: concurrent
+	// generations into the same build directory must not clobber each
+	// other's half-written output. Creating it with open(2) applies the
+	// umask, just as for any other new file.
+	//
+	static std::atomic<unsigned long> counter(0);
+
+	string tmp;
+	int fd;
+	do
+	{
+		tmp = filename + ".tmp." + std::to_string(getpid())
+			+ "." + std::to_string(counter++);
+
+		fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+	}
+	while (fd < 0 and errno == EEXIST);
+
+	if (fd < 0)
+		throw PosixError("error creating temporary file for " + filename);
+
+	// A file that already exists keeps its mode.
+	int error = 0;
+	if (exists and fchmod(fd, s.st_mode & 07777) != 0)
+		error = errno;
+
+	const char *data = contents.data();
+	size_t remaining = contents.size();
+	while (error == 0 and remaining > 0)
+	{
+		const ssize_t written = write(fd, data, remaining);
+		if (written < 0)
+		{
+			if (errno != EINTR)
+				error = errno;
+
+			continue;
+		}
+
+		data += written;
+		remaining -= static_cast<size_t>(written);
+	}
+
+	if (close(fd) != 0 and error == 0)
+		error = errno;
+
+	if (error != 0)
+	{
+		unlink(tmp.c_str());
+		errno = error;
+		throw PosixError("error writing " + tmp);
+	}
+
+	if (rename(tmp.c_str(), filename.c_str()) != 0)
+	{
+		const int renameError = errno;
+		unlink(tmp.c_str());
+		errno = renameError;
+		throw PosixError("error renaming " + tmp + " to " + filename);
+	}
+
+	return true;
+}
+
 } // namespace platform
 } // namespace fabrique
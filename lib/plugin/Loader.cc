@@ -30,6 +30,7 @@
  */
 
 #include <fabrique/Bytestream.hh>
+#include <fabrique/Trace.hh>
 #include <fabrique/strings.hh>
 #include <fabrique/platform/SharedLibrary.hh>
 #include <fabrique/platform/files.hh>
@@ -51,6 +52,7 @@ Loader::Loader(const vector<string>& paths)
 
 std::weak_ptr<Plugin> Loader::Load(string name)
 {
+	Trace::Span span("plugin", name);
 	const string libname = LibraryFilename(name);
 
 	Bytestream& dbg = Bytestream::Debug("plugin.loader");
@@ -85,5 +87,6 @@ std::weak_ptr<Plugin> Loader::Load(string name)
 		return {};
 
 	libraries_.emplace_back(SharedLibrary::Load(filename));
+	filenames_.push_back(filename);
 	return Registry::get().lookup(name);
 }
@@ -57,6 +57,9 @@ const std::string FunctionType::name() const
 
 bool FunctionType::isSubtype(const Type& other) const
 {
+	if (&other == this)
+		return true;
+
 	if (not other.isFunction())
 		return false;
 
@@ -79,11 +82,11 @@ bool FunctionType::isSubtype(const Type& other) const
 		const Type& mine = *typeParameters()[i];
 		const Type& theirs = *t.typeParameters()[i];
 
-		if (not theirs.isSubtype(mine))
+		if (not mine.isSupertype(theirs))
 			return false;
 	}
 
-	return retTy_.isSubtype(t.retTy_);
+	return t.retTy_.isSupertype(retTy_);
 }
 
 
@@ -37,6 +37,7 @@
 #include <fabrique/types/RecordType.hh>
 #include <fabrique/types/TypeContext.hh>
 
+#include <algorithm>
 #include <cassert>
 
 using namespace fabrique;
@@ -47,32 +48,33 @@ using std::vector;
 RecordType*
 RecordType::Create(const NamedTypeVec& fields, TypeContext& ctx)
 {
-	StringMap<const Type&> types;
 	vector<string> names;
+	PtrVec<Type> types;
 
 	for (auto& i : fields)
 	{
 		const string& name = i.first;
 		const Type& type = i.second;
 
+		// As with a map, the first definition of a field wins.
+		if (std::find(names.begin(), names.end(), name) != names.end())
+			continue;
+
 		names.push_back(name);
-		types.emplace(name, type);
+		types.push_back(&type);
 	}
 
-	return new RecordType(types, names, ctx);
+	return new RecordType(ctx.recordShape(names), types, ctx);
 }
 
 
-RecordType::RecordType(const StringMap<const Type&>& fieldTypes,
-                             const vector<string>& fieldNames, TypeContext& ctx)
+RecordType::RecordType(const RecordShape& shape, const PtrVec<Type>& fieldTypes,
+                       TypeContext& ctx)
 	: Type(names::Record, PtrVec<Type>(), ctx),
-	  fieldTypes_(fieldTypes), fieldNames_(fieldNames)
+	  shape_(shape), fieldTypes_(fieldTypes)
 {
-#ifndef NDEBUG
-	for (const string& name : fieldNames_)
-		FAB_ASSERT(fieldTypes_.find(name) != fieldTypes_.end(),
-		           "field type '" + name + "' doesn't exist");
-#endif
+	FAB_ASSERT(shape_.size() == fieldTypes_.size(),
+	           "record shape doesn't match its field types");
 }
 
 RecordType::~RecordType()
@@ -80,11 +82,21 @@ RecordType::~RecordType()
 }
 
 
+Type::TypeMap RecordType::fields() const
+{
+	TypeMap fields;
+	for (size_t i = 0; i < fieldTypes_.size(); i++)
+		fields.emplace(shape_.name(i), *fieldTypes_[i]);
+
+	return fields;
+}
+
+
 bool RecordType::hasFiles() const
 {
-	for (auto& field : fields())
+	for (const Type *t : fieldTypes_)
 	{
-		if (field.second.hasFiles())
+		if (t->hasFiles())
 			return true;
 	}
 
@@ -94,8 +106,8 @@ bool RecordType::hasFiles() const
 
 bool RecordType::hasOutput() const
 {
-	for (auto& field : fields())
-		if (field.second.hasOutput())
+	for (const Type *t : fieldTypes_)
+		if (t->hasOutput())
 			return true;
 
 	return false;
@@ -104,6 +116,9 @@ bool RecordType::hasOutput() const
 
 bool RecordType::isSubtype(const Type& t) const
 {
+	if (&t == this)
+		return true;
+
 	if (t.name() != name())
 		return false;
 
@@ -111,14 +126,16 @@ bool RecordType::isSubtype(const Type& t) const
 	if (not rt)
 		return false;
 
-	size_t fieldsChecked = 0;
-	for (auto& theirField : rt->fields())
+	// Records with the same shape have their fields at the same offsets.
+	const bool sameShape = (&rt->shape_ == &shape_);
+
+	for (size_t theirs = 0; theirs < rt->fieldTypes_.size(); theirs++)
 	{
-		const string& name = theirField.first;
-		const Type& theirType = theirField.second;
+		const size_t ours = sameShape
+			? theirs
+			: shape_.offset(rt->shape_.name(theirs));
 
-		auto i = fieldTypes_.find(name);
-		if (i == fieldTypes_.end())
+		if (ours == RecordShape::NoField)
 			return false;
 
 		//
@@ -126,13 +143,10 @@ bool RecordType::isSubtype(const Type& t) const
 		// record[foo:special_int] to record[foo:int]
 		// but not the other way around.
 		//
-		// TODO: add test for this
-		//
-		const Type& ourType = i->second;
-		if (not ourType.isSubtype(theirType))
+		const Type& ourType = *fieldTypes_[ours];
+		const Type& theirType = *rt->fieldTypes_[theirs];
+		if (not theirType.isSupertype(ourType))
 			return false;
-
-		++fieldsChecked;
 	}
 
 	return true;
@@ -163,14 +177,11 @@ const Type& RecordType::supertype(const Type& t) const
 		const string& name = field.first;
 		const Type& fieldType = field.second;
 
-		auto i = rt->fieldTypes_.find(name);
-		if (i == rt->fieldTypes_.end())
+		const size_t i = rt->shape_.offset(name);
+		if (i == RecordShape::NoField)
 			continue;
 
-		FAB_ASSERT(i->first == name, "found name (" + i->first + ") != " + name);
-		FAB_ASSERT(i->second, "field type (" + name + ") is null");
-
-		const Type& supertype = fieldType.supertype(i->second);
+		const Type& supertype = fieldType.supertype(rt->fieldType(i));
 		if (supertype)
 			commonFields.emplace_back(name, supertype);
 	}
@@ -182,28 +193,21 @@ void RecordType::PrettyPrint(Bytestream& out, unsigned int /*indent*/) const
 {
 	out << Bytestream::Type << names::Record << Bytestream::Reset;
 
-	if (fieldNames_.empty())
+	if (fieldTypes_.empty())
 		return;
 
 	out << Bytestream::Operator << '[';
 
-	bool first = true;
-	for (const string& name : fieldNames_)
+	for (size_t i = 0; i < fieldTypes_.size(); i++)
 	{
-		if (not first)
+		if (i > 0)
 			out << Bytestream::Operator << ", "
 			;
 
-		first = false;
-
-		auto i = fieldTypes_.find(name);
-		FAB_ASSERT(i != fieldTypes_.end(), "no such type " + name);
-
-		const Type& type = i->second;
 		out
-			<< Bytestream::Definition << name
+			<< Bytestream::Definition << shape_.name(i)
 			<< Bytestream::Operator << ':'
-			<< type
+			<< *fieldTypes_[i]
 			;
 	}
 
@@ -106,6 +106,9 @@ const Type& SequenceType::supertype(const Type& other) const
 
 bool SequenceType::isSubtype(const Type& other) const
 {
+	if (&other == this)
+		return true;
+
 	if (not other.isOrdered())
 		return false;
 
@@ -35,6 +35,7 @@
 #include <fabrique/types/TypeContext.hh>
 #include <fabrique/types/TypeError.hh>
 
+#include <atomic>
 #include <cassert>
 
 using namespace fabrique;
@@ -57,9 +58,16 @@ string Type::UntypedPart(string name)
 }
 
 
+static Type::ID NextID()
+{
+	static std::atomic<Type::ID>& next = *new std::atomic<Type::ID>(0);
+	return next++;
+}
+
+
 Type::Type(const std::string& name, const PtrVec<Type>& params,
            TypeContext& parent)
-	: parent_(parent), typeName_(name), parameters_(params)
+	: parent_(parent), id_(NextID()), typeName_(name), parameters_(params)
 {
 	FAB_ASSERT(not typeName_.empty(), "empty type name");
 }
@@ -67,7 +75,7 @@ Type::Type(const std::string& name, const PtrVec<Type>& params,
 
 bool Type::isSupertype(const Type& t) const
 {
-	return t.isSubtype(*this);
+	return parent_.isSubtype(t, *this);
 }
 
 
@@ -113,7 +121,12 @@ Type* Type::Create(const std::string& name, const PtrVec<Type>& params,
 
 bool Type::operator == (const Type& t) const
 {
-	return t.isSupertype(*this) and t.isSubtype(*this);
+	// Structural types are interned by TypeContext, so identical types
+	// are usually the very same object.
+	if (&t == this)
+		return true;
+
+	return t.isSupertype(*this) and isSupertype(t);
 }
 
 
@@ -38,6 +38,7 @@
 #include <fabrique/types/FileType.hh>
 #include <fabrique/types/FunctionType.hh>
 #include <fabrique/types/IntegerType.hh>
+#include <fabrique/types/RecordShape.hh>
 #include <fabrique/types/RecordType.hh>
 #include <fabrique/types/SequenceType.hh>
 #include <fabrique/types/StringType.hh>
@@ -75,11 +76,22 @@ TypeContext::TypeContext()
 	integerType();
 	outputFileType();
 	stringType();
+
+	// Create all of our well-known types before any evaluation (possibly
+	// on several threads) can look them up.
+	fileListType();
+	typeType();
+}
+
+TypeContext::~TypeContext()
+{
 }
 
 
 const Type& TypeContext::find(const string& name, const PtrVec<Type>& params)
 {
+	std::lock_guard<std::recursive_mutex> guard(lock_);
+
 	auto i = types.find(QualifiedName(name, params));
 	if (i != types.end())
 		return *i->second.get();
@@ -186,17 +198,34 @@ TypeContext::functionType(const Type& in, const Type& out)
 const FunctionType&
 TypeContext::functionType(const PtrVec<Type>& argTypes, const Type& retType)
 {
-	FunctionType *t = FunctionType::Create(argTypes, retType);
-	//Register(t);
+	std::lock_guard<std::recursive_mutex> guard(lock_);
 
-	return *t;
+	// Function types are registered under their full signature.
+	PtrVec<Type> signature(argTypes);
+	signature.push_back(&retType);
+
+	auto i = types.find(QualifiedName(names::Function, signature));
+	if (i != types.end())
+		return dynamic_cast<const FunctionType&>(*i->second);
+
+	return dynamic_cast<const FunctionType&>(
+		Register(FunctionType::Create(argTypes, retType)));
 }
 
 const RecordType&
 TypeContext::recordType(const Type::NamedTypeVec& fields)
 {
-	RecordType *t = RecordType::Create(fields, *this);
-	//Register(t);
+	std::lock_guard<std::recursive_mutex> guard(lock_);
+
+	// Record types all have the same name and no type parameters,
+	// so they are interned by their (ordered) field names and types.
+	RecordKey key;
+	for (auto& f : fields)
+		key.emplace_back(f.first, &f.second);
+
+	std::unique_ptr<RecordType>& t = records_[key];
+	if (not t)
+		t.reset(RecordType::Create(fields, *this));
 
 	return *t;
 }
@@ -208,9 +237,52 @@ TypeContext::typeType()
 	return t;
 }
 
+const RecordShape&
+TypeContext::recordShape(const std::vector<string>& fieldNames)
+{
+	std::lock_guard<std::recursive_mutex> guard(lock_);
+
+	std::unique_ptr<RecordShape>& s = shapes_[fieldNames];
+	if (not s)
+	{
+		const auto id = static_cast<RecordShape::ID>(shapes_.size() - 1);
+		s.reset(new RecordShape(id, fieldNames));
+	}
+
+	return *s;
+}
+
+bool
+TypeContext::isSubtype(const Type& sub, const Type& super)
+{
+	if (&sub == &super)
+		return true;
+
+	const uint64_t key = (static_cast<uint64_t>(sub.id()) << 32) | super.id();
+
+	{
+		std::lock_guard<std::mutex> guard(subtypeLock_);
+		auto i = subtypes_.find(key);
+		if (i != subtypes_.end())
+			return i->second;
+	}
+
+	// Structural checks recurse back into this method (for field types,
+	// parameter types, etc.), so don't hold the lock while computing.
+	const bool result = sub.isSubtype(super);
+
+	std::lock_guard<std::mutex> guard(subtypeLock_);
+	subtypes_.emplace(key, result);
+
+	return result;
+}
+
+
 const Type&
 TypeContext::Register(Type *t)
 {
+	std::lock_guard<std::recursive_mutex> guard(lock_);
+
 	auto fullName(QualifiedName(t->name(), t->parameters_));
 	FAB_ASSERT(types.find(fullName) == types.end(), "redefining type");
 